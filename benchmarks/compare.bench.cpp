@@ -0,0 +1,70 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include "inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <string_view>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+template<typename String>
+void compare_equal(benchmark::State& state)
+{
+    const auto length = static_cast<std::size_t>(state.range(0));
+    const std::string text(length, 'x');
+    const String a{text.data(), text.size()};
+    const String b{text.data(), text.size()};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a == b);
+    }
+}
+BENCHMARK_TEMPLATE(compare_equal, tj::string)->Range(8, 4096);
+BENCHMARK_TEMPLATE(compare_equal, std::string)->Range(8, 4096);
+BENCHMARK_TEMPLATE(compare_equal, std::string_view)->Range(8, 4096);
+
+// Copies of one tj::string share their characters.
+void compare_copies_tj_string(benchmark::State& state)
+{
+    const auto length = static_cast<std::size_t>(state.range(0));
+    const std::string text(length, 'x');
+    const tj::string a{text.data(), text.size()};
+    const tj::string b{a};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a == b);
+    }
+}
+BENCHMARK(compare_copies_tj_string)->Range(8, 4096);
+
+template<typename String>
+void compare_ordering(benchmark::State& state)
+{
+    const auto length = static_cast<std::size_t>(state.range(0));
+    std::string text(length, 'x');
+    const String a{text.data(), text.size()};
+    text.back() = 'y';
+    const String b{text.data(), text.size()};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a.compare(b));
+    }
+}
+BENCHMARK_TEMPLATE(compare_ordering, tj::string)->Range(8, 4096);
+BENCHMARK_TEMPLATE(compare_ordering, std::string)->Range(8, 4096);
+BENCHMARK_TEMPLATE(compare_ordering, std::string_view)->Range(8, 4096);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,101 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include "inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+void tj_string_from_short_literal(benchmark::State& state)
+{
+    using namespace tj::literals;
+    for (auto _ : state) {
+        auto s = "GET /index"_is;
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK(tj_string_from_short_literal);
+
+void tj_string_from_long_literal(benchmark::State& state)
+{
+    using namespace tj::literals;
+    for (auto _ : state) {
+        auto s = "content-type: application/json; charset=utf-8"_is;
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK(tj_string_from_long_literal);
+
+// from_literal references string constants like `_is` literals.
+void tj_string_from_long_constant(benchmark::State& state)
+{
+    for (auto _ : state) {
+        auto s = tj::string::from_literal("content-type: application/json; charset=utf-8");
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK(tj_string_from_long_constant);
+
+void std_string_from_short_literal(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::string s{"GET /index"};
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK(std_string_from_short_literal);
+
+void std_string_from_long_literal(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::string s{"content-type: application/json; charset=utf-8"};
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK(std_string_from_long_literal);
+
+void std_string_view_from_long_literal(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::string_view s{"content-type: application/json; charset=utf-8"};
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK(std_string_view_from_long_literal);
+
+// Strings that always use the pool, whether or not it is the default.
+using pool_string = basic_string<char, std::char_traits<char>, pool_allocator<char>>;
+
+template<typename String, const char* Literal>
+void from_pointer(benchmark::State& state)
+{
+    // Copy to a mutable buffer, so tj::string cannot treat it as a literal.
+    char buf[64];
+    std::strcpy(buf, Literal);
+    const char* p = buf;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p);
+        String s{p, std::strlen(p)};
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK_TEMPLATE(from_pointer, tj::string, short_literal);
+BENCHMARK_TEMPLATE(from_pointer, tj::string, long_literal);
+BENCHMARK_TEMPLATE(from_pointer, pool_string, long_literal);
+BENCHMARK_TEMPLATE(from_pointer, std::string, short_literal);
+BENCHMARK_TEMPLATE(from_pointer, std::string, long_literal);
+BENCHMARK_TEMPLATE(from_pointer, std::string_view, long_literal);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,97 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/flat_map.hpp>
+#include <tj/flat_set.hpp>
+#include <tj/string.hpp>
+
+#include "inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+constexpr std::size_t key_count = 10000;
+
+template<typename String, typename Set = std::unordered_set<String, std::hash<String>, std::equal_to<>>>
+void insert(benchmark::State& state)
+{
+    const auto keys = make_keys(key_count, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        Set set;
+        set.reserve(keys.size());
+        for (const auto& key : keys)
+            set.emplace(key.data(), key.size());
+        benchmark::DoNotOptimize(set);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(insert, tj::string)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(insert, std::string)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(insert, std::string_view)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(insert, tj::string, tj::flat_set<tj::string>)->Arg(8)->Arg(32);
+
+// Looks up with the key type itself, so stored and probing keys alike may
+// carry a memoized hash.
+template<typename String, typename Set = std::unordered_set<String, std::hash<String>, std::equal_to<>>>
+void lookup(benchmark::State& state)
+{
+    const auto keys = make_keys(key_count, static_cast<std::size_t>(state.range(0)));
+    Set set;
+    std::vector<String> probes;
+    for (const auto& key : keys) {
+        set.emplace(key.data(), key.size());
+        probes.emplace_back(key.data(), key.size());
+    }
+    for (auto _ : state) {
+        for (const auto& probe : probes)
+            benchmark::DoNotOptimize(set.find(probe));
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK_TEMPLATE(lookup, tj::string)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(lookup, std::string)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(lookup, std::string_view)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(lookup, tj::string, tj::flat_set<tj::string>)->Arg(8)->Arg(32);
+
+// Heterogeneous lookup with a slice, as when probing with parsed input.
+void lookup_slice_tj_string(benchmark::State& state)
+{
+    const auto keys = make_keys(key_count, static_cast<std::size_t>(state.range(0)));
+    std::unordered_set<tj::string, tj::hash, std::equal_to<>> set;
+    for (const auto& key : keys)
+        set.emplace(key.data(), key.size());
+    for (auto _ : state) {
+        for (const auto& key : keys)
+            benchmark::DoNotOptimize(set.find(tj::slice{key}));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(lookup_slice_tj_string)->Arg(8)->Arg(32);
+
+void lookup_slice_flat_set(benchmark::State& state)
+{
+    const auto keys = make_keys(key_count, static_cast<std::size_t>(state.range(0)));
+    tj::flat_set<tj::string> set;
+    for (const auto& key : keys)
+        set.emplace(key.data(), key.size());
+    for (auto _ : state) {
+        for (const auto& key : keys)
+            benchmark::DoNotOptimize(set.find(tj::slice{key}));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(lookup_slice_flat_set)->Arg(8)->Arg(32);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,57 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include "inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+template<typename String>
+String make(const char* literal)
+{
+    return String{literal, std::strlen(literal)};
+}
+
+template<typename String, const char* Literal>
+void copy(benchmark::State& state)
+{
+    const auto original = make<String>(Literal);
+    for (auto _ : state) {
+        String s{original};
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK_TEMPLATE(copy, tj::string, short_literal);
+BENCHMARK_TEMPLATE(copy, tj::string, long_literal);
+BENCHMARK_TEMPLATE(copy, tj::local_string, long_literal);
+BENCHMARK_TEMPLATE(copy, std::string, short_literal);
+BENCHMARK_TEMPLATE(copy, std::string, long_literal);
+BENCHMARK_TEMPLATE(copy, std::string_view, long_literal);
+
+// Every thread copies and destroys the same string, so for tj::string all of
+// them contend on one ref-count.
+template<typename String>
+void shared_copy(benchmark::State& state)
+{
+    static const auto original = make<String>(long_literal);
+    for (auto _ : state) {
+        String s{original};
+        benchmark::DoNotOptimize(s);
+    }
+}
+BENCHMARK_TEMPLATE(shared_copy, tj::string)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(shared_copy, std::string)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,39 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include "inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+// tj::string memoizes the hash of external buffers, so repeated hashing of
+// the same long string is a load.
+template<typename String>
+void hash(benchmark::State& state)
+{
+    const auto length = static_cast<std::size_t>(state.range(0));
+    const std::string text(length, 'x');
+    const String s{text.data(), text.size()};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s);
+        benchmark::DoNotOptimize(std::hash<String>{}(s));
+    }
+}
+BENCHMARK_TEMPLATE(hash, tj::string)->Range(8, 4096);
+BENCHMARK_TEMPLATE(hash, tj::slice)->Range(8, 4096);
+BENCHMARK_TEMPLATE(hash, std::string)->Range(8, 4096);
+BENCHMARK_TEMPLATE(hash, std::string_view)->Range(8, 4096);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,35 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BENCHMARKS_INPUTS_HPP
+#define TJ_STRING_BENCHMARKS_INPUTS_HPP
+
+#include <string>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+
+// Inputs on either side of tj::string::inline_capacity.
+constexpr char short_literal[] = "GET /index";
+constexpr char long_literal[] = "content-type: application/json; charset=utf-8";
+
+/// Returns `n` distinct keys shaped like identifiers, `length` characters long.
+inline std::vector<std::string> make_keys(std::size_t n, std::size_t length)
+{
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        auto key = std::to_string(i * 2654435761u);
+        key.insert(0, length > key.size() ? length - key.size() : 0, 'k');
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
+
+} // namespace bench
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BENCHMARKS_INPUTS_HPP)
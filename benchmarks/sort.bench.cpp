@@ -0,0 +1,103 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/sort.hpp>
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+/// URL-like keys, which share long prefixes and mostly need external buffers.
+std::vector<string> make_keys(std::size_t n)
+{
+    std::mt19937_64 rng{7};
+    std::vector<string> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        const auto key = "https://example.com/items/" + std::to_string(rng() % 1000) + "/"
+                         + std::to_string(rng());
+        keys.emplace_back(key.data(), key.size());
+    }
+    return keys;
+}
+
+void sort_std(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = keys;
+        state.ResumeTiming();
+        std::sort(copy.begin(), copy.end(), [](const string& lhs, const string& rhs) {
+            return lhs.compare(rhs) < 0;
+        });
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(sort_std)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+void sort_multikey(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = keys;
+        state.ResumeTiming();
+        sort_strings(copy.begin(), copy.end());
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(sort_multikey)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+void sort_parallel(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = keys;
+        state.ResumeTiming();
+        parallel_sort_strings(copy.begin(), copy.end());
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(sort_parallel)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Keys of a map differ early, so that sort keys mostly compare their prefixes.
+template<typename Key>
+void map_lookup(benchmark::State& state)
+{
+    std::mt19937_64 rng{11};
+    std::vector<string> keys;
+    for (int i = 0; i != state.range(0); ++i) {
+        const auto key = std::to_string(rng()) + "/records/by-name/entry";
+        keys.emplace_back(key.data(), key.size());
+    }
+    std::map<Key, int, std::less<>> map;
+    for (const auto& key : keys)
+        map.emplace(key, 0);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (auto _ : state) {
+        for (const auto& key : keys)
+            benchmark::DoNotOptimize(map.find(key));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK_TEMPLATE(map_lookup, string)->Arg(1 << 17);
+BENCHMARK_TEMPLATE(map_lookup, sort_key)->Arg(1 << 17);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
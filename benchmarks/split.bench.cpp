@@ -0,0 +1,55 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/split.hpp>
+
+#include <benchmark/benchmark.h>
+#include <ranges>
+#include <string>
+#include <string_view>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+std::string make_csv(std::size_t field_size)
+{
+    std::string csv;
+    while (csv.size() < 4096) {
+        csv.append(field_size, 'f');
+        csv += ',';
+    }
+    return csv;
+}
+
+void split_slices(benchmark::State& state)
+{
+    const auto csv = make_csv(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::size_t size = 0;
+        for (const auto field : split(csv, ','))
+            size += field.size();
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * csv.size()));
+}
+BENCHMARK(split_slices)->ArgName("field")->Arg(4)->Arg(64);
+
+void split_std_views(benchmark::State& state)
+{
+    const auto csv = make_csv(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::size_t size = 0;
+        for (const auto field : std::string_view{csv} | std::views::split(','))
+            size += std::ranges::size(field);
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * csv.size()));
+}
+BENCHMARK(split_std_views)->ArgName("field")->Arg(4)->Arg(64);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,78 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/utf.hpp>
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace tj {
+inline namespace v1 {
+namespace bench {
+namespace {
+
+std::string make_text(bool ascii)
+{
+    std::string text;
+    while (text.size() < 4096)
+        text += ascii ? "The quick brown fox jumps over the lazy dog. "
+                      : "Gr\xc3\xbc\xc3\x9f" "e aus K\xc3\xb6ln, \xe2\x82\xac" "5, \xe6\x97\xa5\xe6\x9c\xac. ";
+    return text;
+}
+
+void utf8_to_utf16(benchmark::State& state)
+{
+    const auto text = make_text(state.range(0) != 0);
+    for (auto _ : state) {
+        auto s = to_utf16(slice{text.data(), text.size()});
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(utf8_to_utf16)->ArgName("ascii")->Arg(1)->Arg(0);
+
+void utf16_to_utf8(benchmark::State& state)
+{
+    const auto text = make_text(state.range(0) != 0);
+    const auto utf16 = to_utf16(slice{text.data(), text.size()});
+    for (auto _ : state) {
+        auto s = to_utf8(utf16);
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(utf16_to_utf8)->ArgName("ascii")->Arg(1)->Arg(0);
+
+void validate_utf8(benchmark::State& state)
+{
+    const auto text = make_text(state.range(0) != 0);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(is_valid_utf8(slice{text.data(), text.size()}));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(validate_utf8)->ArgName("ascii")->Arg(1)->Arg(0);
+
+void validate_utf8_scalar(benchmark::State& state)
+{
+    const auto text = make_text(state.range(0) != 0);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(details::utf::validate_scalar(text.data(), text.size(), nullptr));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(validate_utf8_scalar)->ArgName("ascii")->Arg(1)->Arg(0);
+
+void validated_string(benchmark::State& state)
+{
+    const auto text = make_text(state.range(0) != 0);
+    for (auto _ : state) {
+        auto s = validated_utf8_string(slice{text.data(), text.size()});
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(validated_string)->ArgName("ascii")->Arg(1)->Arg(0);
+
+} // namespace
+} // namespace bench
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,77 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_INTERN_TABLE_HPP
+#define TJ_STRING_BASIC_INTERN_TABLE_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+#include <tj/details/hash.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace tj {
+inline namespace v1 {
+
+/// A thread-safe set of strings where equal strings share one buffer.
+///
+/// Interned strings live as long as the table. The table is split into shards,
+/// each guarded by its own reader-writer lock, so lookups of existing strings
+/// from different threads rarely contend.
+template<typename CharT, typename Traits = std::char_traits<CharT>>
+class basic_intern_table {
+public: // Member types
+    using string_type = basic_string<CharT, Traits>;
+    using slice_type = basic_slice<CharT, Traits>;
+    using size_type = std::size_t;
+
+private:
+    struct alignas(64) shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_set<string_type, basic_hash<CharT, Traits>, std::equal_to<>> strings;
+    };
+
+    static constexpr size_type shard_bits = 6;
+    static constexpr size_type shard_count = size_type{1} << shard_bits;
+
+    std::array<shard, shard_count> shards_;
+
+public: // Constructors
+    basic_intern_table() = default;
+    basic_intern_table(const basic_intern_table&) = delete;
+    basic_intern_table& operator=(const basic_intern_table&) = delete;
+
+public: // Modifiers
+    /// Returns a string equal to `s` that shares its buffer with every other
+    /// string interned from an equal value. Strings short enough to be stored
+    /// inline are returned as-is, since they have no buffer to share.
+    string_type intern(slice_type s);
+
+public: // Capacity
+    /// Returns the number of distinct strings in the table.
+    size_type size() const;
+
+public:
+    /// Returns the table used by `tj::intern`.
+    static basic_intern_table& global();
+};
+
+using intern_table = basic_intern_table<char>;
+using wintern_table = basic_intern_table<wchar_t>;
+
+/// Interns `s` in the global table, see `basic_intern_table::intern`.
+string intern(slice s);
+wstring intern(wslice s);
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_INTERN_TABLE_HPP)
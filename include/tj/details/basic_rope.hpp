@@ -0,0 +1,197 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_ROPE_HPP
+#define TJ_STRING_BASIC_ROPE_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+
+/// An immutable string stored as a balanced tree of `basic_string` leaves,
+/// for documents too large to copy on every edit.
+///
+/// Concatenation and `substr` take O(log n) time and never copy characters
+/// of long leaves: the leaves keep a reference to the strings they were made
+/// from, and ropes share subtrees through their ref-counts. Short leaves are
+/// merged with the adjacent leaf when concatenated, as long as the result
+/// stays within `leaf_merge_limit`, so that a rope built from many small
+/// pieces does not degrade into a tree of tiny leaves.
+///
+/// The characters are not contiguous; use `chunks()` to visit the leaves in
+/// order, e.g. to fill the `iovec` array of a `writev` call, or `flatten()`
+/// to copy them into a single string.
+template<typename CharT, typename Traits = std::char_traits<CharT>,
+         typename Allocator = default_allocator<CharT>, typename RefCount = atomic_ref_count>
+class basic_rope {
+public: // Member types
+    using string_type = basic_string<CharT, Traits, Allocator, RefCount>;
+    using slice_type = basic_slice<CharT, Traits>;
+
+    using traits_type = Traits;
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+    static constexpr size_type leaf_merge_limit = 256 / sizeof(CharT);
+
+private:
+    struct node {
+        mutable typename RefCount::value_type ref_count;
+        size_type size;
+        /// 0 for leaves.
+        size_type height;
+        [[no_unique_address]] Allocator alloc;
+    };
+
+    struct leaf : node {
+        string_type str;
+        size_type offset;
+    };
+
+    struct branch : node {
+        const node* left;
+        const node* right;
+    };
+
+    using leaf_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<leaf>;
+    using branch_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<branch>;
+
+    const node* root_;
+    [[no_unique_address]] Allocator alloc_;
+
+public:
+    /// Visits the leaves of a rope in order, as one slice per leaf, in
+    /// amortized constant time per step. It refers to the rope's nodes, so it
+    /// is only valid as long as the rope is.
+    class chunk_iterator {
+        friend basic_rope;
+
+        // Sibling heights differ by at most one, so a tree of height h has at
+        // least fib(h + 2) leaves; deeper trees would not fit in memory.
+        static constexpr size_type max_height = 64;
+
+        // The branches on the path to `leaf_` whose right subtrees are still
+        // to be visited, innermost last.
+        std::array<const branch*, max_height> pending_ = {};
+        size_type depth_ = 0;
+        const leaf* leaf_ = nullptr;
+        size_type pos_ = 0;
+
+        chunk_iterator(const node* root, size_type pos) noexcept;
+        void descend(const node* n, size_type pos) noexcept;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = slice_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = slice_type;
+        using pointer = void;
+
+        chunk_iterator() noexcept = default;
+
+        slice_type operator*() const noexcept;
+        chunk_iterator& operator++() noexcept;
+        chunk_iterator operator++(int) noexcept;
+
+        bool operator==(const chunk_iterator& other) const noexcept;
+    };
+
+    class chunk_range {
+        friend basic_rope;
+
+        const node* root_;
+
+        explicit chunk_range(const node* root) noexcept;
+
+    public:
+        chunk_iterator begin() const noexcept;
+        chunk_iterator end() const noexcept;
+    };
+
+public: // Constructors
+    basic_rope() noexcept(noexcept(Allocator()));
+    explicit basic_rope(const Allocator& alloc) noexcept;
+    /// Makes a rope with `s` as its only leaf, sharing its buffer.
+    basic_rope(string_type s, const Allocator& alloc = Allocator());
+    /// Copies `s` into a new leaf.
+    explicit basic_rope(slice_type s, const Allocator& alloc = Allocator());
+    basic_rope(const basic_rope& other) noexcept;
+    basic_rope(basic_rope&& other) noexcept;
+
+    basic_rope& operator=(const basic_rope& other) noexcept;
+    basic_rope& operator=(basic_rope&& other) noexcept;
+
+    ~basic_rope();
+
+public: // Capacity
+    size_type size() const noexcept;
+    size_type length() const noexcept;
+    bool empty() const noexcept;
+    /// Returns the height of the tree; 0 for empty ropes and single leaves.
+    size_type height() const noexcept;
+
+public: // Element access
+    /// Takes O(log n) time, since it has to find the leaf of `pos`.
+    value_type operator[](size_type pos) const noexcept;
+    value_type at(size_type pos) const;
+    chunk_range chunks() const noexcept;
+
+public: // Operations
+    /// Returns the characters in `[pos, pos + count)`, sharing the leaves
+    /// and subtrees of this rope.
+    basic_rope substr(size_type pos = 0, size_type count = npos) const;
+    basic_rope& operator+=(const basic_rope& other);
+    void swap(basic_rope& other) noexcept;
+    /// Copies the characters into a single string, allocating at most once.
+    /// A rope of one whole string returns that string without copying.
+    string_type flatten() const;
+    allocator_type get_allocator() const noexcept;
+
+    friend basic_rope operator+(const basic_rope& lhs, const basic_rope& rhs)
+    {
+        return join(lhs, rhs);
+    }
+
+private:
+    basic_rope(const node* root, const Allocator& alloc) noexcept;
+
+    static void retain(const node* n) noexcept;
+    static void release(const node* n) noexcept;
+    static const leaf* find_leaf(const node* n, size_type& pos) noexcept;
+
+    basic_rope share(const node* n) const noexcept;
+    basic_rope make_leaf(const string_type& s, size_type offset, size_type count) const;
+    static basic_rope make_branch(basic_rope lhs, basic_rope rhs);
+    static basic_rope join(basic_rope lhs, basic_rope rhs);
+    static basic_rope join_right(basic_rope lhs, basic_rope rhs);
+    static basic_rope join_left(basic_rope lhs, basic_rope rhs);
+    static basic_rope rebalance(basic_rope lhs, basic_rope rhs);
+    basic_rope sub(const node* n, size_type first, size_type last) const;
+};
+
+using rope = basic_rope<char>;
+using wrope = basic_rope<wchar_t>;
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
+                                              const basic_rope<CharT, Traits, Allocator, RefCount>& r);
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_ROPE_HPP)
@@ -0,0 +1,76 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_SHARED_SLICE_HPP
+#define TJ_STRING_BASIC_SHARED_SLICE_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_string.hpp>
+#include <tj/details/basic_string_range.hpp>
+
+namespace tj {
+inline namespace v1 {
+
+/// A piece of a string that owns its characters by sharing the string's
+/// buffer, wherever the piece lies in it.
+///
+/// Unlike `basic_string::share_substr`, which must copy pieces that are not
+/// followed by a null character, a shared slice never copies, because it is
+/// not null-terminated and has no `c_str()`. Use `str()` to get a string
+/// when one is needed. Keeping a slice keeps the whole buffer alive.
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+class basic_shared_slice
+  : public details::basic_string_range<CharT, Traits,
+                                       basic_shared_slice<CharT, Traits, Allocator, RefCount>> {
+public: // Member types
+    using base_type = details::basic_string_range<CharT, Traits, basic_shared_slice>;
+    using string_type = basic_string<CharT, Traits, Allocator, RefCount>;
+
+    using traits_type = base_type::traits_type;
+    using value_type = base_type::value_type;
+    using size_type = base_type::size_type;
+    using difference_type = base_type::difference_type;
+    using reference = base_type::reference;
+    using const_reference = base_type::const_reference;
+    using pointer = base_type::pointer;
+    using const_pointer = base_type::const_pointer;
+    using iterator = base_type::iterator;
+    using const_iterator = base_type::const_iterator;
+    using reverse_iterator = base_type::reverse_iterator;
+    using const_reverse_iterator = base_type::const_reverse_iterator;
+
+private:
+    // The characters are kept as an offset into `str_`, rather than a
+    // pointer, since those of an inline string move with it.
+    string_type str_;
+    size_type offset_;
+    size_type size_;
+
+public: // Constructors
+    basic_shared_slice() noexcept;
+    /// Shares the characters of `s` in `[pos, pos + count)`. Throws
+    /// `std::out_of_range` if `pos > s.size()`.
+    explicit basic_shared_slice(string_type s, size_type pos = 0, size_type count = base_type::npos);
+
+public: // Operations
+    /// Returns a shared slice of the characters in `[pos, pos + count)`.
+    /// Throws `std::out_of_range` if `pos > size()`.
+    basic_shared_slice share_substr(size_type pos = 0, size_type count = base_type::npos) const;
+    /// Returns the characters as a string, which shares the buffer if the
+    /// slice is all of it or a suffix, and copies them otherwise.
+    string_type str() const;
+
+public: // basic_string_range
+    //friend base_type;
+    const_pointer get_data() const noexcept;
+    size_type get_size() const noexcept;
+    size_type get_hash() const noexcept;
+};
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_SHARED_SLICE_HPP)
@@ -11,6 +11,7 @@
 #include <tj/details/basic_string_range.hpp>
 
 #include <iterator>
+#include <ranges>
 #include <string>
 
 namespace tj {
@@ -44,17 +45,18 @@ public: // Constructors
     constexpr basic_slice(pointer data, size_type size) noexcept;
     constexpr basic_slice(pointer data) noexcept;
 
-    constexpr basic_slice(const basic_string<CharT, Traits>& s) noexcept;
+    template<typename Allocator, typename RefCount>
+    constexpr basic_slice(const basic_string<CharT, Traits, Allocator, RefCount>& s) noexcept;
 
     template<typename Allocator>
     constexpr basic_slice(const std::basic_string<CharT, Traits, Allocator>& s) noexcept;
 
-    // template<std::contiguous_iterator First, std::sized_sentinel_for<First> Last>
-    template<typename First, typename Last>
+    template<std::contiguous_iterator First, std::sized_sentinel_for<First> Last>
     constexpr basic_slice(First first, Last last);
 
-    template<typename Range>
-    constexpr basic_slice(Range&& rng);
+    template<std::ranges::contiguous_range Range>
+    constexpr basic_slice(Range&& rng)
+        requires(std::is_same_v<std::ranges::range_value_t<Range>, CharT>);
 
     constexpr basic_slice(std::nullptr_t) = delete;
 
@@ -65,6 +67,7 @@ public: // basic_string_range
     //friend base_type;
     constexpr const_pointer get_data() const noexcept;
     constexpr size_type get_size() const noexcept;
+    constexpr size_type get_hash() const noexcept;
 };
 
 } // namespace v1
@@ -0,0 +1,141 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_SPLIT_VIEW_HPP
+#define TJ_STRING_BASIC_SPLIT_VIEW_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <type_traits>
+
+namespace tj {
+inline namespace v1 {
+
+/// What `tj::split` splits on: a character, a sequence of characters, or any
+/// character of a set, made with `any_of`.
+///
+/// The characters of sequences and sets are not copied, so they must outlive
+/// the delimiter. An empty sequence or set is never found.
+template<typename CharT, typename Traits = std::char_traits<CharT>>
+class basic_delimiter {
+public: // Member types
+    using slice_type = basic_slice<CharT, Traits>;
+    using size_type = std::size_t;
+
+private:
+    enum class kind { character, sequence, any_of };
+
+    slice_type chars_;
+    CharT c_{};
+    kind kind_;
+
+    constexpr basic_delimiter(slice_type chars, kind k) noexcept;
+
+public: // Constructors
+    constexpr basic_delimiter(CharT c) noexcept;
+    constexpr basic_delimiter(slice_type s) noexcept;
+    constexpr basic_delimiter(const CharT* s) noexcept;
+
+    /// Makes a delimiter that matches any one of the characters of `set`.
+    static constexpr basic_delimiter any_of(slice_type set) noexcept;
+
+public: // Operations
+    /// Returns the position of the first delimiter in `s` at or after `pos`,
+    /// or `npos` if there is none.
+    constexpr size_type find_in(slice_type s, size_type pos) const noexcept;
+    /// Returns the number of characters a delimiter takes up.
+    constexpr size_type size() const noexcept;
+};
+
+using delimiter = basic_delimiter<char>;
+using wdelimiter = basic_delimiter<wchar_t>;
+
+/// A lazy range of the pieces of a string between delimiters, as returned by
+/// `tj::split` and `tj::split_strings`.
+///
+/// Like `std::views::split`, `n` delimiters give `n + 1` pieces, some of which
+/// may be empty, and an empty string gives none. The delimiters are found
+/// with the vectorized searches of the string, one piece ahead.
+///
+/// `String` is the type of the pieces: a `basic_slice`, which refers to the
+/// characters of the split string, or a `basic_string`, whose pieces are made
+/// with `share_substr()`.
+template<typename String>
+class basic_split_view : public std::ranges::view_interface<basic_split_view<String>> {
+public: // Member types
+    using string_type = String;
+    using traits_type = typename String::traits_type;
+    using char_type = typename traits_type::char_type;
+    using size_type = std::size_t;
+    using slice_type = basic_slice<char_type, traits_type>;
+    using delimiter_type = basic_delimiter<char_type, traits_type>;
+
+private:
+    String str_;
+    delimiter_type delim_;
+
+public:
+    class iterator {
+        friend basic_split_view;
+
+        const basic_split_view* parent_ = nullptr;
+        size_type pos_ = slice_type::npos;
+        /// The end of the current piece, where the next delimiter starts.
+        size_type end_ = slice_type::npos;
+
+        iterator(const basic_split_view* parent, size_type pos) noexcept;
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = String;
+        using difference_type = std::ptrdiff_t;
+        using reference = String;
+        using pointer = void;
+
+        iterator() noexcept = default;
+
+        String operator*() const;
+        iterator& operator++() noexcept;
+        iterator operator++(int) noexcept;
+
+        bool operator==(const iterator& other) const noexcept;
+    };
+
+public: // Constructors
+    basic_split_view(String s, delimiter_type delim) noexcept(std::is_nothrow_move_constructible_v<String>);
+
+public: // Iterators
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+
+public: // Observers
+    const String& base() const noexcept;
+};
+
+/// Splits `s` on `delim` without allocating, into slices that refer to the
+/// characters of `s`.
+basic_split_view<slice> split(slice s, delimiter delim) noexcept;
+basic_split_view<wslice> split(wslice s, wdelimiter delim) noexcept;
+
+/// Splits `s` on `delim` into strings that keep `s` alive. Pieces that fit
+/// inline are stored inline, and the last piece shares the buffer of `s`,
+/// but since strings are null-terminated, other long pieces are copied.
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+basic_split_view<basic_string<CharT, Traits, Allocator, RefCount>>
+split_strings(basic_string<CharT, Traits, Allocator, RefCount> s,
+              std::type_identity_t<basic_delimiter<CharT, Traits>> delim) noexcept;
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_SPLIT_VIEW_HPP)
@@ -9,10 +9,13 @@
 #endif // defined(__cplusplus)
 
 #include <tj/details/basic_string_range.hpp>
+#include <tj/details/ref_count.hpp>
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cstring>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <string>
@@ -34,11 +37,15 @@ struct basic_literal_string_ref {
 using literal_string_ref = basic_literal_string_ref<char>;
 using wliteral_string_reg = basic_literal_string_ref<wchar_t>;
 
+/// Maps files into the buffers of strings, see `tj::map_file`.
+struct file_mapping;
+
 } // namespace details
 
-template<typename CharT, typename Traits>
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
 class basic_string
-  : public details::basic_string_range<CharT, Traits, basic_string<CharT, Traits>> {
+  : public details::basic_string_range<CharT, Traits,
+                                       basic_string<CharT, Traits, Allocator, RefCount>> {
 public: // Member types
     using base_type = details::basic_string_range<CharT, Traits, basic_string_view<CharT, Traits>>;
 
@@ -54,14 +61,47 @@ public: // Member types
     using const_iterator = base_type::const_iterator;
     using reverse_iterator = base_type::reverse_iterator;
     using const_reverse_iterator = base_type::const_reverse_iterator;
+    using allocator_type = Allocator;
 
 private:
     using char_type = CharT;
 
+    /// Header of a heap-allocated buffer; the characters follow immediately.
+    ///
+    /// The allocator is kept in the header, rather than in the string, so that
+    /// the last reference frees through the resource that allocated it.
+    ///
+    /// Buffers made by `tj::map_file` are not allocated: the header ends the
+    /// anonymous page mapped in front of the file, so the characters that
+    /// follow are the file's. Their capacity is `mapped_capacity`, and a
+    /// `mapped_region` in front of the header says what to unmap.
     struct external_buffer {
-        std::atomic_size_t ref_count{1};
+        typename RefCount::value_type ref_count{1};
+        /// Memoized `hash()` of the whole buffer, or zero if not computed yet.
+        std::atomic_size_t hash{0};
+        /// Number of code units the buffer has room for, excluding the
+        /// null-terminator; strings built by `basic_string_builder` may use
+        /// fewer.
+        size_type capacity;
+        [[no_unique_address]] Allocator allocator;
+
+        external_buffer(size_type n, const Allocator& alloc) noexcept
+          : capacity{n}
+          , allocator{alloc}
+        {}
+    };
+
+    struct mapped_region {
+        void* base;
+        std::size_t length;
     };
 
+    static constexpr size_type mapped_capacity = static_cast<size_type>(-1);
+
+    using block_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<external_buffer>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
     union buffer {
         value_type* literal;
         external_buffer* external;
@@ -69,33 +109,95 @@ private:
 
     static constexpr value_type empty_literal_[1] = {};
 
-    // TODO: We can also support SBO storage if we steal one byte of the size
+    // The low bits of `tagged.size` tag how the characters are stored: in a
+    // literal that outlives the string, in a ref-counted external buffer,
+    // inline in the bytes of the string object itself, or in a part of an
+    // external buffer shared with other strings. Inline strings are kept in
+    // `chars`, which overlaps `tagged`: the first code unit holds the tag and
+    // length, so that they land in the low-order byte of `tagged.size`, and
+    // the characters (including the null-terminator) follow. That is why
+    // `size` must come first and why the inline representation is
+    // little-endian only. Shared strings keep their offset into the buffer in
+    // the high half of `tagged.size` and their length below it. The tags of
+    // both ref-counted representations have the low bit set.
+    static constexpr size_type tag_bits = 2;
+    static constexpr size_type tag_mask = (1 << tag_bits) - 1;
+    static constexpr size_type literal_tag = 0;
+    static constexpr size_type external_tag = 1;
+    static constexpr size_type inline_tag = 2;
+    static constexpr size_type shared_tag = 3;
+    static constexpr size_type inline_size_mask = 0xff;
+    static constexpr size_type shared_offset_shift = sizeof(size_type) * 4;
+    static constexpr size_type shared_size_mask =
+        (size_type{1} << (shared_offset_shift - tag_bits)) - 1;
+
+    union representation {
+        struct {
+            size_type size;
+            buffer buf;
+        } tagged;
+        char_type chars[(sizeof(size_type) + sizeof(buffer)) / sizeof(char_type)];
+    };
+
+    representation rep_;
 
-    buffer buf_;
-    size_type size_;
+public:
+    /// The longest string that is stored inline without allocating.
+    static constexpr size_type inline_capacity =
+        std::endian::native == std::endian::little
+            ? (sizeof(size_type) + sizeof(buffer)) / sizeof(char_type) - 2
+            : 0;
 
 public: // Constructors
     constexpr basic_string() noexcept;
     constexpr explicit basic_string(details::basic_literal_string_ref<CharT> literal) noexcept;
+    /// Copies the characters of an array; see `from_literal` to refer to a
+    /// string constant instead.
     template<size_type N>
-    explicit basic_string(value_type (&data)[N]) noexcept;
+    explicit basic_string(const CharT (&data)[N]);
     explicit basic_string(std::nullptr_t) = delete;
-    explicit basic_string(pointer data);
-    basic_string(pointer data, size_type len);
+    explicit basic_string(pointer data, const Allocator& alloc = Allocator());
+    basic_string(pointer data, size_type len, const Allocator& alloc = Allocator());
     basic_string(const basic_string& other);
+    /// Steals the buffer of `other` without touching the ref-count, leaving
+    /// `other` as the empty literal.
+    basic_string(basic_string&& other) noexcept;
 
     basic_string& operator=(const basic_string& other);
+    basic_string& operator=(basic_string&& other) noexcept;
+    /// Copies the characters of an array, like the array constructor; assign
+    /// `from_literal(...)` to refer to a string constant instead.
     template<size_type N>
-    basic_string& operator=(value_type (&data)[N]);
+    basic_string& operator=(const CharT (&data)[N]);
     basic_string& operator=(std::nullptr_t) = delete;
 
-    // TODO: Custom move constructor would be slightly more efficient, e.g. it
-    //       does not have to increment then decrement the ref-count.
-
-    // TODO: Move assignment operator could be efficiently implemented using
-    //       swap, which we need anyway.
+    constexpr ~basic_string();
 
-    ~basic_string();
+    /// Returns a string that refers to a string constant, such as a literal
+    /// or a `constexpr` array, instead of copying it, like `_is` does. Being
+    /// `consteval`, it only accepts null-terminated arrays whose characters
+    /// are constant expressions.
+    template<size_type N>
+    static consteval basic_string from_literal(const CharT (&literal)[N]);
+
+public: // Modifiers
+    void swap(basic_string& other) noexcept;
+
+public: // Operations
+    /// Returns a string of the characters in `[pos, pos + count)` that, unlike
+    /// `substr()`, owns them.
+    ///
+    /// Since strings must be null-terminated, the substring only shares the
+    /// buffer of this string when it is followed by a null character, e.g.
+    /// when it is a suffix; otherwise the characters are copied (inline, if
+    /// short enough). Use `share_slice()` to share any substring. Throws
+    /// `std::out_of_range` if `pos > size()`.
+    basic_string share_substr(size_type pos = 0, size_type count = base_type::npos) const;
+    /// Returns the characters in `[pos, pos + count)` as a shared slice,
+    /// which shares the buffer of this string wherever the substring lies
+    /// in it. Throws `std::out_of_range` if `pos > size()`.
+    basic_shared_slice<CharT, Traits, Allocator, RefCount> share_slice(size_type pos = 0,
+                                                                       size_type count = base_type::npos) const;
 
 public: // Element access
     constexpr const_pointer c_str() const noexcept;
@@ -103,17 +205,33 @@ public: // Element access
 private:
     constexpr char_type* external_data() const noexcept;
     static constexpr char_type* external_data(external_buffer* external) noexcept;
+    constexpr char_type* inline_data() const noexcept;
+    constexpr char_type* shared_data() const noexcept;
     static constexpr size_type make_literal_size(size_type n);
     static constexpr size_type make_external_size(size_type n);
+    static constexpr size_type make_inline_size(size_type n);
+    constexpr size_type tagged_size() const noexcept;
     constexpr bool has_external_buffer() const noexcept;
-    static external_buffer* make_external_buf(pointer data, size_type len);
+    constexpr bool has_inline_buffer() const noexcept;
+    constexpr bool has_shared_buffer() const noexcept;
+    constexpr bool is_ref_counted() const noexcept;
+    void init_inline(pointer data, size_type len) noexcept;
+    static constexpr size_type external_blocks(size_type len) noexcept;
+    static external_buffer* allocate_external_buf(size_type capacity, const Allocator& alloc);
+    static external_buffer* make_external_buf(pointer data, size_type len, const Allocator& alloc);
+    static void destroy_external_buf(external_buffer* external) noexcept;
     void copy(const basic_string& other) noexcept;
-    void release() noexcept;
+    void steal(basic_string& other) noexcept;
+    constexpr void release() noexcept;
+
+    friend class basic_string_builder<CharT, Traits, Allocator, RefCount>;
+    friend struct details::file_mapping;
 
 public: // basic_string_range
     //friend base_type;
     constexpr const_pointer get_data() const noexcept;
     constexpr size_type get_size() const noexcept;
+    constexpr size_type get_hash() const noexcept;
 };
 
 } // namespace v1
@@ -142,7 +260,7 @@ inline namespace v1 {
 namespace literals {
 
 template<details::literal_string Literal>
-constexpr string operator""_is();
+constexpr basic_string<typename decltype(Literal)::char_type> operator""_is();
 
 } // namespace literals
 } // namespace v1
@@ -0,0 +1,123 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_STRING_BUILDER_HPP
+#define TJ_STRING_BASIC_STRING_BUILDER_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+
+/// Assembles a `basic_string` in a buffer that the string takes over, so a
+/// builder that has reserved enough room allocates once and copies each
+/// character once.
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+class basic_string_builder {
+public: // Member types
+    using string_type = basic_string<CharT, Traits, Allocator, RefCount>;
+    using slice_type = basic_slice<CharT, Traits>;
+
+    using traits_type = Traits;
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+private:
+    using external_buffer = typename string_type::external_buffer;
+
+    external_buffer* buf_;
+    size_type size_;
+    [[no_unique_address]] Allocator alloc_;
+
+public: // Constructors
+    basic_string_builder() noexcept(noexcept(Allocator()));
+    explicit basic_string_builder(const Allocator& alloc) noexcept;
+    explicit basic_string_builder(size_type capacity, const Allocator& alloc = Allocator());
+    basic_string_builder(const basic_string_builder& other) = delete;
+    basic_string_builder(basic_string_builder&& other) noexcept;
+
+    basic_string_builder& operator=(const basic_string_builder& other) = delete;
+    basic_string_builder& operator=(basic_string_builder&& other) noexcept;
+
+    ~basic_string_builder();
+
+public: // Capacity
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    bool empty() const noexcept;
+    /// Makes room for at least `capacity` characters in total.
+    void reserve(size_type capacity);
+
+public: // Modifiers
+    basic_string_builder& append(slice_type s);
+    basic_string_builder& append(size_type count, value_type c);
+    void push_back(value_type c);
+    /// Appends the characters that `op(p, count)` writes to `p`, up to
+    /// `count`; `op` returns how many it wrote. Like `append`, `op` may read
+    /// the characters of the builder itself.
+    template<typename Operation>
+    basic_string_builder& append_with(size_type count, Operation op);
+    basic_string_builder& operator+=(slice_type s);
+    basic_string_builder& operator+=(value_type c);
+    /// Discards the characters but keeps the buffer.
+    void clear() noexcept;
+
+public: // Element access
+    slice_type view() const noexcept;
+
+public: // Conversion
+    /// Hands the characters over to a string, leaving the builder empty.
+    ///
+    /// Results longer than `string_type::inline_capacity` take over the
+    /// buffer as is, including any unused capacity; shorter results are
+    /// copied inline and the builder keeps its buffer.
+    string_type str() &&;
+
+private:
+    /// Frees a buffer that `grow` replaced once the new characters have been
+    /// written, since they may be read from it.
+    struct retired_buffer {
+        external_buffer* buf = nullptr;
+
+        ~retired_buffer();
+    };
+
+    value_type* grow(size_type count, retired_buffer& retired);
+    void reallocate(size_type capacity, retired_buffer& retired);
+};
+
+/// Concatenates the arguments into a single string, allocating at most once.
+template<typename... Args>
+string concat(const Args&... args)
+    requires(std::is_convertible_v<const Args&, slice> && ...);
+
+template<typename... Args>
+wstring concat(const Args&... args)
+    requires(sizeof...(Args) != 0 && (std::is_convertible_v<const Args&, wslice> && ...));
+
+/// Copies each part into a string, allocating one buffer for all of them;
+/// the strings share it and its ref-count. Parts short enough to be stored
+/// inline are copied inline instead.
+template<std::ranges::forward_range R>
+std::vector<string> make_strings(const R& parts)
+    requires std::is_convertible_v<std::ranges::range_reference_t<const R>, slice>;
+
+template<std::ranges::forward_range R>
+std::vector<wstring> make_strings(const R& parts)
+    requires std::is_convertible_v<std::ranges::range_reference_t<const R>, wslice>;
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_STRING_BUILDER_HPP)
@@ -58,6 +58,11 @@ public: // Capacity
     [[nodiscard]] constexpr bool empty() const noexcept;
     constexpr size_type size() const noexcept;
 
+public: // Substrings
+    /// Returns a slice of the characters in `[pos, pos + count)`, without
+    /// copying. Throws `std::out_of_range` if `pos > size()`.
+    constexpr basic_slice<CharT, Traits> substr(size_type pos = 0, size_type count = npos) const;
+
 public: // Operations
         //    constexpr int compare(const basic_string& rhs) const noexcept
         //    {
@@ -79,16 +84,46 @@ public: // Operations
     constexpr int compare(T&&) const noexcept
         requires(std::is_convertible_v<T, basic_slice<CharT, Traits>>);
     constexpr int compare(basic_slice<CharT, Traits> rhs) const noexcept;
+    /// Same as `compare(rhs) == 0`, but checks the sizes first and the
+    /// characters only if `rhs` refers to other characters.
+    template<class T>
+    constexpr bool equals(T&&) const noexcept
+        requires(std::is_convertible_v<T, basic_slice<CharT, Traits>>);
+    constexpr bool equals(basic_slice<CharT, Traits> rhs) const noexcept;
+
+    /// Returns the hash of the code units, which is the same for every string
+    /// type with equal contents (see `tj::basic_hash`).
+    constexpr size_type hash() const noexcept;
 
-    // constexpr bool contains(basic_slice s) const noexcept;
-    // constexpr bool contains(value_type c) const noexcept;
-    // constexpr bool contains(pointer p) const noexcept;
+    constexpr bool starts_with(basic_slice<CharT, Traits> s) const noexcept;
+    constexpr bool starts_with(value_type c) const noexcept;
+    constexpr bool ends_with(basic_slice<CharT, Traits> s) const noexcept;
+    constexpr bool ends_with(value_type c) const noexcept;
+    constexpr bool contains(basic_slice<CharT, Traits> s) const noexcept;
+    constexpr bool contains(value_type c) const noexcept;
 
 public: // Search
-        // constexpr size_type find(basic_slice str, size_type pos = 0) const noexcept;
-        // constexpr size_type find(pointer p, size_type pos = 0) const noexcept;
-        // constexpr size_type find(value_type c, size_type pos = 0) const noexcept;
-        // constexpr size_type find(pointer s, size_type pos, size_type count) const noexcept;
+    // The search functions behave like those of `std::basic_string_view`. For
+    // narrow strings with the default traits they use SSE2/AVX2 kernels when
+    // the target supports them, see `tj/details/search.hpp`.
+    constexpr size_type find(basic_slice<CharT, Traits> s, size_type pos = 0) const noexcept;
+    constexpr size_type find(value_type c, size_type pos = 0) const noexcept;
+    constexpr size_type find(pointer s, size_type pos, size_type count) const noexcept;
+    constexpr size_type rfind(basic_slice<CharT, Traits> s, size_type pos = npos) const noexcept;
+    constexpr size_type rfind(value_type c, size_type pos = npos) const noexcept;
+    constexpr size_type rfind(pointer s, size_type pos, size_type count) const noexcept;
+    constexpr size_type find_first_of(basic_slice<CharT, Traits> s,
+                                      size_type pos = 0) const noexcept;
+    constexpr size_type find_first_of(value_type c, size_type pos = 0) const noexcept;
+    constexpr size_type find_last_of(basic_slice<CharT, Traits> s,
+                                     size_type pos = npos) const noexcept;
+    constexpr size_type find_last_of(value_type c, size_type pos = npos) const noexcept;
+    constexpr size_type find_first_not_of(basic_slice<CharT, Traits> s,
+                                          size_type pos = 0) const noexcept;
+    constexpr size_type find_first_not_of(value_type c, size_type pos = 0) const noexcept;
+    constexpr size_type find_last_not_of(basic_slice<CharT, Traits> s,
+                                         size_type pos = npos) const noexcept;
+    constexpr size_type find_last_not_of(value_type c, size_type pos = npos) const noexcept;
 };
 
 #if __has_include(<compare>)
@@ -120,7 +155,7 @@ inline constexpr bool operator==(const basic_string_range<CharT, Traits, Derived
                                  const T& rhs) noexcept
     requires(std::is_convertible_v<T, basic_slice<CharT, Traits>>)
 {
-    return lhs.compare(static_cast<basic_slice<CharT, Traits>>(rhs)) == 0;
+    return lhs.equals(static_cast<basic_slice<CharT, Traits>>(rhs));
 }
 
 #else
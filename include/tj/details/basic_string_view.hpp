@@ -42,7 +42,8 @@ public: // Constructors
     constexpr basic_string_view() noexcept;
     constexpr basic_string_view(const basic_string_view& other) noexcept = default;
     constexpr basic_string_view(pointer data) noexcept;
-    constexpr basic_string_view(const basic_string<CharT, Traits>& s) noexcept;
+    template<typename Allocator, typename RefCount>
+    constexpr basic_string_view(const basic_string<CharT, Traits, Allocator, RefCount>& s) noexcept;
 
     template<typename Allocator>
     constexpr basic_string_view(const std::basic_string<CharT, Traits, Allocator>& s) noexcept;
@@ -59,6 +60,7 @@ public: // basic_string_range
     //friend base_type;
     constexpr const_pointer get_data() const noexcept;
     constexpr size_type get_size() const noexcept;
+    constexpr size_type get_hash() const noexcept;
 };
 
 } // namespace v1
@@ -0,0 +1,74 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_FLAT_MAP_DETAILS_HPP
+#define TJ_STRING_FLAT_MAP_DETAILS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/flat_table.hpp>
+#include <tj/details/hash.hpp>
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+
+/// An open-addressing hash map meant for `tj::basic_string` keys, see
+/// `details::flat_table`.
+///
+/// Elements are stored inline in a flat array, so a lookup touches the control
+/// bytes, the matching slots and, only if the key handles differ in size and
+/// address, their characters. With the default hash and equality, lookups
+/// accept anything convertible to `tj::basic_slice`, without constructing a
+/// key.
+template<typename Key, typename T,
+         typename Hash = basic_hash<typename Key::traits_type::char_type, typename Key::traits_type>,
+         typename KeyEqual = std::equal_to<>,
+         typename Allocator = std::allocator<std::pair<const Key, T>>>
+class flat_map : public details::flat_table<details::map_policy<Key, T>, Hash, KeyEqual, Allocator> {
+    using base_type = details::flat_table<details::map_policy<Key, T>, Hash, KeyEqual, Allocator>;
+
+public: // Member types
+    using mapped_type = T;
+    using typename base_type::key_type;
+    using typename base_type::value_type;
+    using typename base_type::size_type;
+    using typename base_type::iterator;
+    using typename base_type::const_iterator;
+
+public: // Constructors
+    using base_type::base_type;
+
+public: // Element access
+    /// Returns the value of `key`, throwing `std::out_of_range` if absent.
+    template<typename K = key_type>
+    T& at(const K& key)
+        requires(details::lookup_key<Hash, KeyEqual, K, key_type>);
+    template<typename K = key_type>
+    const T& at(const K& key) const
+        requires(details::lookup_key<Hash, KeyEqual, K, key_type>);
+    T& operator[](const key_type& key);
+    T& operator[](key_type&& key);
+
+public: // Modifiers
+    /// Inserts a value constructed from `args` if `key` is absent; unlike
+    /// `emplace`, `args` are not used otherwise.
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args);
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args);
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value);
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& value);
+};
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_FLAT_MAP_DETAILS_HPP)
@@ -0,0 +1,35 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_FLAT_SET_DETAILS_HPP
+#define TJ_STRING_FLAT_SET_DETAILS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/flat_table.hpp>
+#include <tj/details/hash.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace tj {
+inline namespace v1 {
+
+/// An open-addressing hash set meant for `tj::basic_string` keys, see
+/// `tj::flat_map`.
+template<typename Key,
+         typename Hash = basic_hash<typename Key::traits_type::char_type, typename Key::traits_type>,
+         typename KeyEqual = std::equal_to<>, typename Allocator = std::allocator<Key>>
+class flat_set : public details::flat_table<details::set_policy<Key>, Hash, KeyEqual, Allocator> {
+    using base_type = details::flat_table<details::set_policy<Key>, Hash, KeyEqual, Allocator>;
+
+public: // Constructors
+    using base_type::base_type;
+};
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_FLAT_SET_DETAILS_HPP)
@@ -0,0 +1,260 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_FLAT_TABLE_HPP
+#define TJ_STRING_FLAT_TABLE_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+/// Control byte of a slot: the low 7 bits of the hash of the key in a full
+/// slot, or one of the negative markers below.
+using ctrl_t = signed char;
+
+inline constexpr ctrl_t ctrl_empty = -128;
+inline constexpr ctrl_t ctrl_deleted = -2;
+/// Follows the last slot and stops iteration.
+inline constexpr ctrl_t ctrl_sentinel = -1;
+
+/// A group of control bytes that are matched at once, using SSE2 if the
+/// target supports it. The masks have bit `i` set if byte `i` matches.
+class ctrl_group {
+    const ctrl_t* ctrl_;
+
+public:
+    static constexpr std::size_t width = 16;
+
+    explicit ctrl_group(const ctrl_t* ctrl) noexcept;
+
+    std::uint32_t match(ctrl_t h2) const noexcept;
+    std::uint32_t match_empty() const noexcept;
+    std::uint32_t match_empty_or_deleted() const noexcept;
+};
+
+/// `true` if `Hash` and `KeyEqual` accept any `K` in place of `Key`.
+template<typename Hash, typename KeyEqual, typename K, typename Key>
+concept lookup_key =
+    std::is_same_v<K, Key>
+    || (requires { typename Hash::is_transparent; } && requires { typename KeyEqual::is_transparent; });
+
+template<typename Key>
+struct set_policy {
+    using key_type = Key;
+    using value_type = Key;
+    static constexpr bool constant_iterators = true;
+
+    static const Key& key(const value_type& value) noexcept { return value; }
+    static void relocate(value_type* dst, value_type* src) noexcept;
+};
+
+template<typename Key, typename T>
+struct map_policy {
+    using key_type = Key;
+    using value_type = std::pair<const Key, T>;
+    static constexpr bool constant_iterators = false;
+
+    static const Key& key(const value_type& value) noexcept { return value.first; }
+    static void relocate(value_type* dst, value_type* src) noexcept;
+};
+
+/// Open-addressing hash table shared by `tj::flat_map` and `tj::flat_set`.
+///
+/// Elements are stored in one array of slots, next to an array with a control
+/// byte per slot. A lookup hashes the key once, then scans the control bytes
+/// of a probed group for the low 7 bits of the hash, and only compares keys of
+/// slots that match. Groups are aligned, so an erased slot whose group still
+/// has an empty slot can become empty again instead of a tombstone.
+///
+/// Elements are relocated when the table grows, so references and iterators
+/// are invalidated by insertions, as with `std::vector`. Growth rehashes every
+/// key; `tj::basic_string` keys with external buffers memoize their hash, so
+/// their characters are not read again.
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+class flat_table {
+public: // Member types
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+
+private:
+    union slot {
+        value_type value;
+
+        slot() noexcept {}
+        ~slot() {}
+    };
+
+    template<bool Const>
+    class basic_iterator {
+        friend flat_table;
+        template<bool>
+        friend class basic_iterator;
+
+        const ctrl_t* ctrl_ = nullptr;
+        slot* slot_ = nullptr;
+
+        basic_iterator(const ctrl_t* ctrl, slot* s) noexcept;
+        void skip_free() noexcept;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = flat_table::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        basic_iterator() noexcept = default;
+        template<bool OtherConst>
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            requires(Const && !OtherConst);
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+        basic_iterator& operator++() noexcept;
+        basic_iterator operator++(int) noexcept;
+
+        template<bool OtherConst>
+        bool operator==(const basic_iterator<OtherConst>& other) const noexcept;
+    };
+
+public:
+    using const_iterator = basic_iterator<true>;
+    using iterator = std::conditional_t<Policy::constant_iterators, const_iterator, basic_iterator<false>>;
+
+private:
+    using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+    using slot_traits = std::allocator_traits<slot_allocator>;
+    using ctrl_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ctrl_t>;
+    using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    /// The control bytes of a table without slots.
+    static inline ctrl_t empty_ctrl_[1] = {ctrl_sentinel};
+
+    ctrl_t* ctrl_ = empty_ctrl_;
+    slot* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    /// Number of empty slots that may still be filled before growing.
+    size_type growth_left_ = 0;
+    /// The control byte that the slot last claimed by `prepare_insert` had,
+    /// so that `construct_at` can give it back if construction throws.
+    ctrl_t claimed_ctrl_ = ctrl_empty;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual eq_;
+    [[no_unique_address]] Allocator alloc_;
+
+public: // Constructors
+    flat_table() = default;
+    explicit flat_table(size_type capacity, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(),
+                        const Allocator& alloc = Allocator());
+    explicit flat_table(const Allocator& alloc);
+    flat_table(std::initializer_list<value_type> values, const Hash& hash = Hash(),
+               const KeyEqual& eq = KeyEqual(), const Allocator& alloc = Allocator());
+    flat_table(const flat_table& other);
+    flat_table(flat_table&& other) noexcept;
+
+    flat_table& operator=(const flat_table& other);
+    flat_table& operator=(flat_table&& other) noexcept;
+
+    ~flat_table();
+
+public: // Iterators
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator cbegin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cend() const noexcept;
+
+public: // Capacity
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    /// Returns the number of slots; the table grows when 7/8 of them are used.
+    size_type capacity() const noexcept;
+
+public: // Modifiers
+    void clear() noexcept;
+    std::pair<iterator, bool> insert(const value_type& value);
+    std::pair<iterator, bool> insert(value_type&& value);
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+    iterator erase(const_iterator pos);
+    template<typename K = key_type>
+    size_type erase(const K& key)
+        requires(lookup_key<Hash, KeyEqual, K, key_type> && !std::is_convertible_v<const K&, const_iterator>);
+    void swap(flat_table& other) noexcept;
+
+public: // Lookup
+    template<typename K = key_type>
+    iterator find(const K& key)
+        requires(lookup_key<Hash, KeyEqual, K, key_type>);
+    template<typename K = key_type>
+    const_iterator find(const K& key) const
+        requires(lookup_key<Hash, KeyEqual, K, key_type>);
+    template<typename K = key_type>
+    bool contains(const K& key) const
+        requires(lookup_key<Hash, KeyEqual, K, key_type>);
+    template<typename K = key_type>
+    size_type count(const K& key) const
+        requires(lookup_key<Hash, KeyEqual, K, key_type>);
+
+public: // Hash policy
+    /// Makes room for `n` elements without growing.
+    void reserve(size_type n);
+    hasher hash_function() const;
+    key_equal key_eq() const;
+    allocator_type get_allocator() const noexcept;
+
+protected:
+    template<typename K>
+    size_type find_index(const K& key, std::size_t hash) const;
+    /// Returns the slot of `key`, and `true` if it is free and must be filled
+    /// by the caller with `construct_at`.
+    template<typename K>
+    std::pair<size_type, bool> find_or_prepare_insert(const K& key);
+    template<typename... Args>
+    void construct_at(size_type index, Args&&... args);
+    iterator iterator_at(size_type index) noexcept;
+    const_iterator iterator_at(size_type index) const noexcept;
+    value_type& value_at(size_type index) noexcept;
+
+private:
+    size_type prepare_insert(std::size_t hash);
+    size_type find_free(std::size_t hash) const noexcept;
+    void set_ctrl(size_type index, ctrl_t ctrl) noexcept;
+    void erase_at(size_type index) noexcept;
+    void grow();
+    void rehash(size_type capacity);
+    void destroy() noexcept;
+    static ctrl_t h2(std::size_t hash) noexcept;
+    static size_type capacity_for(size_type n) noexcept;
+};
+
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_FLAT_TABLE_HPP)
@@ -0,0 +1,52 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_HASH_HPP
+#define TJ_STRING_HASH_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tj {
+inline namespace v1 {
+
+/// Transparent hash function for `tj::basic_string`, `tj::basic_string_view`,
+/// `tj::basic_slice` and anything convertible to `tj::basic_slice`.
+///
+/// All of them hash equal contents to equal values, so a `tj::slice` can probe
+/// an unordered container keyed by `tj::string` without a conversion:
+///
+///     std::unordered_map<tj::string, int, tj::hash, std::equal_to<>> map;
+///     map.find(tj::slice{"key"});
+template<typename CharT, typename Traits = std::char_traits<CharT>>
+struct basic_hash {
+    using is_transparent = void;
+
+    template<typename Derived>
+    constexpr std::size_t operator()(
+        const details::basic_string_range<CharT, Traits, Derived>& s) const noexcept;
+    constexpr std::size_t operator()(basic_slice<CharT, Traits> s) const noexcept;
+};
+
+using hash = basic_hash<char>;
+using whash = basic_hash<wchar_t>;
+
+namespace details {
+
+/// Hashes the code units in `[data, data + size)`.
+///
+/// Usable in constant expressions, and gives the same result at compile time
+/// as at run time.
+template<typename CharT>
+constexpr std::size_t hash_code_units(const CharT* data, std::size_t size) noexcept;
+
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_HASH_HPP)
@@ -0,0 +1,76 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_INTERN_TABLE_IMPL_HPP
+#define TJ_STRING_BASIC_INTERN_TABLE_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_intern_table.hpp>
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename CharT, typename Traits>
+inline auto basic_intern_table<CharT, Traits>::intern(slice_type s) -> string_type
+{
+    if (s.size() <= string_type::inline_capacity)
+        return string_type{s.data(), s.size()};
+
+    // The low bits select the bucket inside the shard, so use the high bits
+    // to select the shard.
+    const auto hash = s.hash();
+    auto& shard = shards_[hash >> (sizeof(size_type) * 8 - shard_bits)];
+
+    {
+        std::shared_lock lock{shard.mutex};
+        const auto it = shard.strings.find(s);
+        if (it != shard.strings.end())
+            return *it;
+    }
+
+    std::unique_lock lock{shard.mutex};
+    // Another thread may have interned `s` while the lock was released.
+    const auto it = shard.strings.find(s);
+    if (it != shard.strings.end())
+        return *it;
+    return *shard.strings.emplace(s.data(), s.size()).first;
+}
+
+template<typename CharT, typename Traits>
+inline auto basic_intern_table<CharT, Traits>::size() const -> size_type
+{
+    size_type n = 0;
+    for (const auto& shard : shards_) {
+        std::shared_lock lock{shard.mutex};
+        n += shard.strings.size();
+    }
+    return n;
+}
+
+template<typename CharT, typename Traits>
+inline auto basic_intern_table<CharT, Traits>::global() -> basic_intern_table&
+{
+    static basic_intern_table table;
+    return table;
+}
+
+inline string intern(slice s)
+{
+    return intern_table::global().intern(s);
+}
+
+inline wstring intern(wslice s)
+{
+    return wintern_table::global().intern(s);
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_INTERN_TABLE_IMPL_HPP)
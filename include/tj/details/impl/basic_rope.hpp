@@ -0,0 +1,485 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_ROPE_IMPL_HPP
+#define TJ_STRING_BASIC_ROPE_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_rope.hpp>
+
+#include <algorithm>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::chunk_iterator::chunk_iterator(const node* root,
+                                                                                      size_type pos) noexcept
+  : pos_{pos}
+{
+    if (root && pos < root->size)
+        descend(root, pos);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_rope<CharT, Traits, Allocator, RefCount>::chunk_iterator::descend(const node* n,
+                                                                                   size_type pos) noexcept
+{
+    while (n->height != 0) {
+        const auto b = static_cast<const branch*>(n);
+        if (pos < b->left->size) {
+            pending_[depth_++] = b;
+            n = b->left;
+        } else {
+            pos -= b->left->size;
+            n = b->right;
+        }
+    }
+    leaf_ = static_cast<const leaf*>(n);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::chunk_iterator::operator*() const noexcept
+    -> slice_type
+{
+    return {leaf_->str.data() + leaf_->offset, leaf_->size};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::chunk_iterator::operator++() noexcept
+    -> chunk_iterator&
+{
+    // Each branch is pushed and popped once, so a full walk visits every
+    // node once.
+    pos_ += leaf_->size;
+    if (depth_ == 0)
+        leaf_ = nullptr;
+    else
+        descend(pending_[--depth_]->right, 0);
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::chunk_iterator::operator++(int) noexcept
+    -> chunk_iterator
+{
+    auto result = *this;
+    ++*this;
+    return result;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline bool basic_rope<CharT, Traits, Allocator, RefCount>::chunk_iterator::operator==(
+    const chunk_iterator& other) const noexcept
+{
+    return pos_ == other.pos_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::chunk_range::chunk_range(const node* root) noexcept
+  : root_{root}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::chunk_range::begin() const noexcept
+    -> chunk_iterator
+{
+    return {root_, 0};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::chunk_range::end() const noexcept
+    -> chunk_iterator
+{
+    return {root_, root_ ? root_->size : 0};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope() noexcept(noexcept(Allocator()))
+  : basic_rope{Allocator()}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope(const Allocator& alloc) noexcept
+  : root_{nullptr}
+  , alloc_{alloc}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope(string_type s, const Allocator& alloc)
+  : basic_rope{alloc}
+{
+    if (!s.empty()) {
+        auto leaf = make_leaf(s, 0, s.size());
+        root_ = std::exchange(leaf.root_, nullptr);
+    }
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope(slice_type s, const Allocator& alloc)
+  : basic_rope{string_type{s.data(), s.size(), alloc}, alloc}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope(const basic_rope& other) noexcept
+  : root_{other.root_}
+  , alloc_{other.alloc_}
+{
+    retain(root_);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope(basic_rope&& other) noexcept
+  : root_{std::exchange(other.root_, nullptr)}
+  , alloc_{other.alloc_}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::basic_rope(const node* root,
+                                                                  const Allocator& alloc) noexcept
+  : root_{root}
+  , alloc_{alloc}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::operator=(const basic_rope& other) noexcept
+    -> basic_rope&
+{
+    retain(other.root_);
+    release(root_);
+    root_ = other.root_;
+    alloc_ = other.alloc_;
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::operator=(basic_rope&& other) noexcept
+    -> basic_rope&
+{
+    if (this != &other) {
+        release(root_);
+        root_ = std::exchange(other.root_, nullptr);
+        alloc_ = other.alloc_;
+    }
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_rope<CharT, Traits, Allocator, RefCount>::~basic_rope()
+{
+    release(root_);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::size() const noexcept -> size_type
+{
+    return root_ ? root_->size : 0;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::length() const noexcept -> size_type
+{
+    return size();
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline bool basic_rope<CharT, Traits, Allocator, RefCount>::empty() const noexcept
+{
+    return root_ == nullptr;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::height() const noexcept -> size_type
+{
+    return root_ ? root_->height : 0;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::operator[](size_type pos) const noexcept
+    -> value_type
+{
+    const auto l = find_leaf(root_, pos);
+    return l->str.data()[l->offset + pos];
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::at(size_type pos) const -> value_type
+{
+    if (pos >= size())
+        throw std::out_of_range("pos");
+    return (*this)[pos];
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::chunks() const noexcept -> chunk_range
+{
+    return chunk_range{root_};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::substr(size_type pos, size_type count) const
+    -> basic_rope
+{
+    if (pos > size())
+        throw std::out_of_range("pos");
+    count = std::min(count, size() - pos);
+    if (count == 0)
+        return basic_rope{alloc_};
+    return sub(root_, pos, pos + count);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::operator+=(const basic_rope& other)
+    -> basic_rope&
+{
+    return *this = join(*this, other);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_rope<CharT, Traits, Allocator, RefCount>::swap(basic_rope& other) noexcept
+{
+    using std::swap;
+    swap(root_, other.root_);
+    swap(alloc_, other.alloc_);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::flatten() const -> string_type
+{
+    if (!root_)
+        return {};
+
+    if (root_->height == 0) {
+        const auto l = static_cast<const leaf*>(root_);
+        if (l->offset == 0 && l->size == l->str.size())
+            return l->str;
+    }
+
+    if (root_->size <= string_type::inline_capacity) {
+        // The result is stored inline, so assemble it on the stack.
+        value_type buf[string_type::inline_capacity];
+        auto out = buf;
+        for (const auto chunk : chunks())
+            out = traits_type::copy(out, chunk.data(), chunk.size()) + chunk.size();
+        return string_type{buf, root_->size, alloc_};
+    }
+
+    basic_string_builder<CharT, Traits, Allocator, RefCount> builder{root_->size, alloc_};
+    for (const auto chunk : chunks())
+        builder.append(chunk);
+    return std::move(builder).str();
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::get_allocator() const noexcept -> allocator_type
+{
+    return alloc_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_rope<CharT, Traits, Allocator, RefCount>::retain(const node* n) noexcept
+{
+    if (n)
+        RefCount::increment(n->ref_count);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_rope<CharT, Traits, Allocator, RefCount>::release(const node* n) noexcept
+{
+    if (!n || !RefCount::decrement(n->ref_count))
+        return;
+
+    if (n->height == 0) {
+        const auto l = const_cast<leaf*>(static_cast<const leaf*>(n));
+        leaf_allocator alloc{l->alloc};
+        std::destroy_at(l);
+        std::allocator_traits<leaf_allocator>::deallocate(alloc, l, 1);
+    } else {
+        const auto b = const_cast<branch*>(static_cast<const branch*>(n));
+        release(b->left);
+        release(b->right);
+        branch_allocator alloc{b->alloc};
+        std::destroy_at(b);
+        std::allocator_traits<branch_allocator>::deallocate(alloc, b, 1);
+    }
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::find_leaf(const node* n, size_type& pos) noexcept
+    -> const leaf*
+{
+    while (n->height != 0) {
+        const auto b = static_cast<const branch*>(n);
+        if (pos < b->left->size) {
+            n = b->left;
+        } else {
+            pos -= b->left->size;
+            n = b->right;
+        }
+    }
+    return static_cast<const leaf*>(n);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::share(const node* n) const noexcept -> basic_rope
+{
+    retain(n);
+    return basic_rope{n, alloc_};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::make_leaf(const string_type& s,
+                                                                      size_type offset,
+                                                                      size_type count) const -> basic_rope
+{
+    leaf_allocator alloc{alloc_};
+    const auto l = std::allocator_traits<leaf_allocator>::allocate(alloc, 1);
+    ::new (static_cast<void*>(l)) leaf{{{1}, count, 0, alloc_}, s, offset};
+    return basic_rope{l, alloc_};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::make_branch(basic_rope lhs, basic_rope rhs)
+    -> basic_rope
+{
+    const auto size = lhs.root_->size + rhs.root_->size;
+    if (lhs.root_->height == 0 && rhs.root_->height == 0 && size <= leaf_merge_limit) {
+        value_type buf[leaf_merge_limit];
+        auto out = buf;
+        for (const auto part : {&lhs, &rhs}) {
+            const auto chunk = *part->chunks().begin();
+            out = traits_type::copy(out, chunk.data(), chunk.size()) + chunk.size();
+        }
+        return lhs.make_leaf(string_type{buf, size, lhs.alloc_}, 0, size);
+    }
+
+    branch_allocator alloc{lhs.alloc_};
+    const auto b = std::allocator_traits<branch_allocator>::allocate(alloc, 1);
+    const auto height = 1 + std::max(lhs.root_->height, rhs.root_->height);
+    ::new (static_cast<void*>(b)) branch{{{1}, size, height, lhs.alloc_},
+                                         std::exchange(lhs.root_, nullptr),
+                                         std::exchange(rhs.root_, nullptr)};
+    return basic_rope{b, lhs.alloc_};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::join(basic_rope lhs, basic_rope rhs)
+    -> basic_rope
+{
+    if (lhs.empty())
+        return rhs;
+    if (rhs.empty())
+        return lhs;
+
+    // A short leaf joined to a tree is merged into the tree's adjacent leaf
+    // if it fits, so that appending pieces one at a time fills leaves up to
+    // `leaf_merge_limit` instead of adding a leaf per piece.
+    if (rhs.height() == 0 && lhs.height() != 0) {
+        auto pos = lhs.size() - 1;
+        const auto last = find_leaf(lhs.root_, pos);
+        if (last->size + rhs.size() <= leaf_merge_limit) {
+            auto merged = make_branch(lhs.share(last), std::move(rhs));
+            return join(lhs.sub(lhs.root_, 0, lhs.size() - last->size), std::move(merged));
+        }
+    }
+    if (lhs.height() == 0 && rhs.height() != 0) {
+        size_type pos = 0;
+        const auto first = find_leaf(rhs.root_, pos);
+        if (lhs.size() + first->size <= leaf_merge_limit) {
+            auto merged = make_branch(std::move(lhs), rhs.share(first));
+            return join(std::move(merged), rhs.sub(rhs.root_, first->size, rhs.size()));
+        }
+    }
+
+    // Like AVL trees, sibling heights differ by at most one. Joining a
+    // shorter tree descends the spine of the taller one to a subtree of
+    // about its height, so it takes time proportional to the difference.
+    if (lhs.height() > rhs.height() + 1)
+        return join_right(std::move(lhs), std::move(rhs));
+    if (rhs.height() > lhs.height() + 1)
+        return join_left(std::move(lhs), std::move(rhs));
+    return make_branch(std::move(lhs), std::move(rhs));
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::join_right(basic_rope lhs, basic_rope rhs)
+    -> basic_rope
+{
+    const auto b = static_cast<const branch*>(lhs.root_);
+    return rebalance(lhs.share(b->left), join(lhs.share(b->right), std::move(rhs)));
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::join_left(basic_rope lhs, basic_rope rhs)
+    -> basic_rope
+{
+    const auto b = static_cast<const branch*>(rhs.root_);
+    return rebalance(join(std::move(lhs), rhs.share(b->left)), rhs.share(b->right));
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::rebalance(basic_rope lhs, basic_rope rhs)
+    -> basic_rope
+{
+    // The heights differ by at most two here, which one or two rotations fix.
+    if (rhs.height() > lhs.height() + 1) {
+        const auto r = static_cast<const branch*>(rhs.root_);
+        if (r->left->height > r->right->height) {
+            const auto rl = static_cast<const branch*>(r->left);
+            return make_branch(make_branch(std::move(lhs), rhs.share(rl->left)),
+                               make_branch(rhs.share(rl->right), rhs.share(r->right)));
+        }
+        return make_branch(make_branch(std::move(lhs), rhs.share(r->left)), rhs.share(r->right));
+    }
+    if (lhs.height() > rhs.height() + 1) {
+        const auto l = static_cast<const branch*>(lhs.root_);
+        if (l->right->height > l->left->height) {
+            const auto lr = static_cast<const branch*>(l->right);
+            return make_branch(make_branch(lhs.share(l->left), lhs.share(lr->left)),
+                               make_branch(lhs.share(lr->right), std::move(rhs)));
+        }
+        return make_branch(lhs.share(l->left), make_branch(lhs.share(l->right), std::move(rhs)));
+    }
+    return make_branch(std::move(lhs), std::move(rhs));
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_rope<CharT, Traits, Allocator, RefCount>::sub(const node* n, size_type first,
+                                                                size_type last) const -> basic_rope
+{
+    if (first == 0 && last == n->size)
+        return share(n);
+
+    if (n->height == 0) {
+        const auto l = static_cast<const leaf*>(n);
+        return make_leaf(l->str, l->offset + first, last - first);
+    }
+
+    const auto b = static_cast<const branch*>(n);
+    const auto mid = b->left->size;
+    if (last <= mid)
+        return sub(b->left, first, last);
+    if (first >= mid)
+        return sub(b->right, first - mid, last - mid);
+    return join(sub(b->left, first, mid), sub(b->right, 0, last - mid));
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
+                                                     const basic_rope<CharT, Traits, Allocator, RefCount>& r)
+{
+    for (const auto chunk : r.chunks())
+        os.write(chunk.data(), chunk.size());
+    return os;
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_ROPE_IMPL_HPP)
@@ -0,0 +1,88 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_SHARED_SLICE_IMPL_HPP
+#define TJ_STRING_BASIC_SHARED_SLICE_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_shared_slice.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_shared_slice<CharT, Traits, Allocator, RefCount>::basic_shared_slice() noexcept
+  : offset_{0}
+  , size_{0}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_shared_slice<CharT, Traits, Allocator, RefCount>::basic_shared_slice(string_type s,
+                                                                                size_type pos,
+                                                                                size_type count)
+  : str_{std::move(s)}
+  , offset_{pos}
+{
+    if (pos > str_.size())
+        throw std::out_of_range("pos");
+    size_ = std::min(count, str_.size() - pos);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_shared_slice<CharT, Traits, Allocator, RefCount>::share_substr(size_type pos,
+                                                                               size_type count) const
+    -> basic_shared_slice
+{
+    if (pos > size_)
+        throw std::out_of_range("pos");
+    return basic_shared_slice{str_, offset_ + pos, std::min(count, size_ - pos)};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_shared_slice<CharT, Traits, Allocator, RefCount>::str() const -> string_type
+{
+    if (offset_ == 0 && size_ == str_.size())
+        return str_;
+    return str_.share_substr(offset_, size_);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_shared_slice<CharT, Traits, Allocator, RefCount>::get_data() const noexcept
+    -> const_pointer
+{
+    return str_.data() + offset_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_shared_slice<CharT, Traits, Allocator, RefCount>::get_size() const noexcept
+    -> size_type
+{
+    return size_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_shared_slice<CharT, Traits, Allocator, RefCount>::get_hash() const noexcept
+    -> size_type
+{
+    return details::hash_code_units(get_data(), size_);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::share_slice(size_type pos,
+                                                                          size_type count) const
+    -> basic_shared_slice<CharT, Traits, Allocator, RefCount>
+{
+    return basic_shared_slice<CharT, Traits, Allocator, RefCount>{*this, pos, count};
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_SHARED_SLICE_IMPL_HPP)
@@ -32,8 +32,9 @@ inline constexpr basic_slice<CharT, Traits>::basic_slice(pointer data) noexcept
 {}
 
 template<typename CharT, typename Traits>
+template<typename Allocator, typename RefCount>
 inline constexpr basic_slice<CharT, Traits>::basic_slice(
-    const basic_string<CharT, Traits>& s) noexcept
+    const basic_string<CharT, Traits, Allocator, RefCount>& s) noexcept
   : basic_slice{s.data(), s.size()}
 {}
 
@@ -45,15 +46,16 @@ inline constexpr basic_slice<CharT, Traits>::basic_slice(
 {}
 
 template<typename CharT, typename Traits>
-template<typename First, typename Last>
+template<std::contiguous_iterator First, std::sized_sentinel_for<First> Last>
 inline constexpr basic_slice<CharT, Traits>::basic_slice(First first, Last last)
   : data_{std::to_address(first)}
   , size_{static_cast<size_type>(std::distance(first, last))}
 {}
 
 template<typename CharT, typename Traits>
-template<typename Range>
+template<std::ranges::contiguous_range Range>
 inline constexpr basic_slice<CharT, Traits>::basic_slice(Range&& rng)
+    requires(std::is_same_v<std::ranges::range_value_t<Range>, CharT>)
   : basic_slice{std::begin(rng), std::end(rng)}
 {}
 
@@ -69,6 +71,12 @@ inline constexpr auto basic_slice<CharT, Traits>::get_size() const noexcept -> s
     return size_;
 }
 
+template<typename CharT, typename Traits>
+inline constexpr auto basic_slice<CharT, Traits>::get_hash() const noexcept -> size_type
+{
+    return details::hash_code_units(data_, size_);
+}
+
 } // namespace v1
 } // namespace tj
 
@@ -0,0 +1,159 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_SPLIT_VIEW_IMPL_HPP
+#define TJ_STRING_BASIC_SPLIT_VIEW_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_split_view.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename CharT, typename Traits>
+inline constexpr basic_delimiter<CharT, Traits>::basic_delimiter(slice_type chars, kind k) noexcept
+  : chars_{chars}
+  , kind_{k}
+{}
+
+template<typename CharT, typename Traits>
+inline constexpr basic_delimiter<CharT, Traits>::basic_delimiter(CharT c) noexcept
+  : c_{c}
+  , kind_{kind::character}
+{}
+
+template<typename CharT, typename Traits>
+inline constexpr basic_delimiter<CharT, Traits>::basic_delimiter(slice_type s) noexcept
+  : basic_delimiter{s, kind::sequence}
+{}
+
+template<typename CharT, typename Traits>
+inline constexpr basic_delimiter<CharT, Traits>::basic_delimiter(const CharT* s) noexcept
+  : basic_delimiter{slice_type{s}, kind::sequence}
+{}
+
+template<typename CharT, typename Traits>
+inline constexpr auto basic_delimiter<CharT, Traits>::any_of(slice_type set) noexcept -> basic_delimiter
+{
+    return {set, kind::any_of};
+}
+
+template<typename CharT, typename Traits>
+inline constexpr auto basic_delimiter<CharT, Traits>::find_in(slice_type s, size_type pos) const noexcept
+    -> size_type
+{
+    switch (kind_) {
+    case kind::character:
+        return s.find(c_, pos);
+    case kind::sequence:
+        return chars_.empty() ? slice_type::npos : s.find(chars_, pos);
+    case kind::any_of:
+        return s.find_first_of(chars_, pos);
+    }
+    return slice_type::npos;
+}
+
+template<typename CharT, typename Traits>
+inline constexpr auto basic_delimiter<CharT, Traits>::size() const noexcept -> size_type
+{
+    return kind_ == kind::sequence ? chars_.size() : 1;
+}
+
+template<typename String>
+inline basic_split_view<String>::iterator::iterator(const basic_split_view* parent, size_type pos) noexcept
+  : parent_{parent}
+  , pos_{pos}
+{
+    const slice_type s = parent_->str_;
+    end_ = std::min(parent_->delim_.find_in(s, pos_), s.size());
+}
+
+template<typename String>
+inline String basic_split_view<String>::iterator::operator*() const
+{
+    if constexpr (std::is_same_v<String, slice_type>)
+        return slice_type{parent_->str_.data() + pos_, end_ - pos_};
+    else
+        return parent_->str_.share_substr(pos_, end_ - pos_);
+}
+
+template<typename String>
+inline auto basic_split_view<String>::iterator::operator++() noexcept -> iterator&
+{
+    const slice_type s = parent_->str_;
+    if (end_ == s.size()) {
+        pos_ = end_ = slice_type::npos;
+    } else {
+        pos_ = end_ + parent_->delim_.size();
+        end_ = std::min(parent_->delim_.find_in(s, pos_), s.size());
+    }
+    return *this;
+}
+
+template<typename String>
+inline auto basic_split_view<String>::iterator::operator++(int) noexcept -> iterator
+{
+    auto result = *this;
+    ++*this;
+    return result;
+}
+
+template<typename String>
+inline bool basic_split_view<String>::iterator::operator==(const iterator& other) const noexcept
+{
+    return pos_ == other.pos_;
+}
+
+template<typename String>
+inline basic_split_view<String>::basic_split_view(String s, delimiter_type delim) noexcept(
+    std::is_nothrow_move_constructible_v<String>)
+  : str_{std::move(s)}
+  , delim_{delim}
+{}
+
+template<typename String>
+inline auto basic_split_view<String>::begin() const noexcept -> iterator
+{
+    return str_.empty() ? iterator{} : iterator{this, 0};
+}
+
+template<typename String>
+inline auto basic_split_view<String>::end() const noexcept -> iterator
+{
+    return {};
+}
+
+template<typename String>
+inline const String& basic_split_view<String>::base() const noexcept
+{
+    return str_;
+}
+
+inline basic_split_view<slice> split(slice s, delimiter delim) noexcept
+{
+    return {s, delim};
+}
+
+inline basic_split_view<wslice> split(wslice s, wdelimiter delim) noexcept
+{
+    return {s, delim};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_split_view<basic_string<CharT, Traits, Allocator, RefCount>>
+split_strings(basic_string<CharT, Traits, Allocator, RefCount> s,
+              std::type_identity_t<basic_delimiter<CharT, Traits>> delim) noexcept
+{
+    return {std::move(s), delim};
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_SPLIT_VIEW_IMPL_HPP)
@@ -13,159 +13,367 @@
 #include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <memory>
 #include <ostream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+
+#if __has_include(<sys/mman.h>)
+#    include <sys/mman.h>
+#endif
 
 namespace tj {
 inline namespace v1 {
 
-template<typename CharT, typename Traits>
-inline constexpr basic_string<CharT, Traits>::basic_string() noexcept
-  : size_{make_literal_size(0)}
-{
-    buf_.literal = &empty_literal_[0];
-}
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr basic_string<CharT, Traits, Allocator, RefCount>::basic_string() noexcept
+  : rep_{.tagged = {make_literal_size(0), {&empty_literal_[0]}}}
+{}
 
-template<typename CharT, typename Traits>
-inline constexpr basic_string<CharT, Traits>::basic_string(
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr basic_string<CharT, Traits, Allocator, RefCount>::basic_string(
     details::basic_literal_string_ref<CharT> literal) noexcept
-  : size_{make_literal_size(literal.size)}
+  : rep_{.tagged = {make_literal_size(literal.size), {literal.data}}}
 {
-    buf_.literal = literal.data;
+    if (!std::is_constant_evaluated())
+        details::count_construction(details::stat_literal_constructions, literal.size);
 }
 
-template<typename CharT, typename Traits>
-template<basic_string<CharT, Traits>::size_type N>
-inline basic_string<CharT, Traits>::basic_string(value_type (&data)[N]) noexcept
-  : size_{make_external_size(N - 1)}
-{
-    buf_.external = make_external_buf(&data[0], N - 1);
-}
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+template<basic_string<CharT, Traits, Allocator, RefCount>::size_type N>
+inline basic_string<CharT, Traits, Allocator, RefCount>::basic_string(const CharT (&data)[N])
+  : basic_string{&data[0], N - 1}
+{}
 
-template<typename CharT, typename Traits>
-inline basic_string<CharT, Traits>::basic_string(pointer data)
-  : basic_string{data, traits_type::length(data)}
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string<CharT, Traits, Allocator, RefCount>::basic_string(pointer data,
+                                                                   const Allocator& alloc)
+  : basic_string{data, traits_type::length(data), alloc}
 {}
 
-template<typename CharT, typename Traits>
-inline basic_string<CharT, Traits>::basic_string(pointer data, size_type len)
-  : size_{make_external_size(len)}
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string<CharT, Traits, Allocator, RefCount>::basic_string(pointer data, size_type len,
+                                                                   const Allocator& alloc)
 {
-    buf_.external = make_external_buf(data, len);
+    if (len <= inline_capacity) {
+        init_inline(data, len);
+        details::count_construction(details::stat_inline_constructions, len);
+    } else {
+        rep_.tagged.size = make_external_size(len);
+        rep_.tagged.buf.external = make_external_buf(data, len, alloc);
+        details::count_construction(details::stat_external_constructions, len);
+    }
 }
 
-template<typename CharT, typename Traits>
-inline basic_string<CharT, Traits>::basic_string(const basic_string& other)
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string<CharT, Traits, Allocator, RefCount>::basic_string(const basic_string& other)
 {
     copy(other);
 }
 
-template<typename CharT, typename Traits>
-inline auto basic_string<CharT, Traits>::operator=(const basic_string& other) -> basic_string&
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string<CharT, Traits, Allocator, RefCount>::basic_string(basic_string&& other) noexcept
+{
+    steal(other);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::operator=(const basic_string& other) -> basic_string&
 {
     release();
     copy(other);
     return *this;
 }
 
-template<typename CharT, typename Traits>
-template<basic_string<CharT, Traits>::size_type N>
-inline auto basic_string<CharT, Traits>::operator=(value_type (&data)[N]) -> basic_string&
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::operator=(basic_string&& other) noexcept -> basic_string&
 {
-    return (*this) = basic_string{data, N - 1};
+    if (this != &other) {
+        release();
+        steal(other);
+    }
+    return *this;
 }
-template<typename CharT, typename Traits>
-inline basic_string<CharT, Traits>::~basic_string()
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+template<basic_string<CharT, Traits, Allocator, RefCount>::size_type N>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::operator=(const CharT (&data)[N]) -> basic_string&
+{
+    return (*this) = basic_string{data};
+}
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr basic_string<CharT, Traits, Allocator, RefCount>::~basic_string()
 {
     release();
 }
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::get_data() const noexcept -> const_pointer
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+template<basic_string<CharT, Traits, Allocator, RefCount>::size_type N>
+inline consteval auto basic_string<CharT, Traits, Allocator, RefCount>::from_literal(
+    const CharT (&literal)[N]) -> basic_string
+{
+    if (literal[N - 1] != CharT())
+        throw std::invalid_argument("string constants must be null-terminated");
+    return basic_string{details::basic_literal_string_ref<CharT>{&literal[0], N - 1}};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string<CharT, Traits, Allocator, RefCount>::swap(basic_string& other) noexcept
+{
+    std::swap(rep_, other.rep_);
+}
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::share_substr(size_type pos,
+                                                                           size_type count) const
+    -> basic_string
+{
+    const auto n = get_size();
+    if (pos > n)
+        throw std::out_of_range("pos");
+    count = std::min(count, n - pos);
+
+    const auto data = c_str();
+    if (count <= inline_capacity || data[pos + count] != char_type())
+        return has_external_buffer() || has_shared_buffer()
+                   ? basic_string{data + pos, count, rep_.tagged.buf.external->allocator}
+                   : basic_string{data + pos, count};
+
+    basic_string result;
+    if (!is_ref_counted()) {
+        result.rep_.tagged.buf.literal = rep_.tagged.buf.literal + pos;
+        result.rep_.tagged.size = make_literal_size(count);
+        details::count_construction(details::stat_literal_constructions, count);
+        return result;
+    }
+
+    const auto offset = static_cast<size_type>(data + pos - external_data());
+    if (offset >> (sizeof(size_type) * 8 - shared_offset_shift) != 0 || count > shared_size_mask)
+        return basic_string{data + pos, count, rep_.tagged.buf.external->allocator};
+
+    RefCount::increment(rep_.tagged.buf.external->ref_count);
+    details::count(details::stat_copies);
+    result.rep_.tagged.buf.external = rep_.tagged.buf.external;
+    result.rep_.tagged.size = (offset << shared_offset_shift) | (count << tag_bits) | shared_tag;
+    details::count_construction(details::stat_shared_constructions, count);
+    return result;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::get_data() const noexcept -> const_pointer
 {
     return c_str();
 }
 
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::c_str() const noexcept -> const_pointer
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::c_str() const noexcept -> const_pointer
 {
     if (has_external_buffer())
         return external_data();
-    return buf_.literal;
+    if (has_inline_buffer())
+        return inline_data();
+    if (has_shared_buffer())
+        return shared_data();
+    return rep_.tagged.buf.literal;
 }
 
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::get_size() const noexcept -> size_type
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::get_size() const noexcept -> size_type
 {
-    return size_ >> 1;
+    const auto size = tagged_size();
+    if ((size & tag_mask) == inline_tag)
+        return (size & inline_size_mask) >> tag_bits;
+    if ((size & tag_mask) == shared_tag)
+        return (size >> tag_bits) & shared_size_mask;
+    return size >> tag_bits;
 }
 
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::external_data() const noexcept -> char_type*
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::get_hash() const noexcept -> size_type
 {
-    return external_data(buf_.external);
+    if (!has_external_buffer())
+        return details::hash_code_units(c_str(), get_size());
+
+    // Racing threads compute the same value, so relaxed ordering suffices.
+    auto& cached = rep_.tagged.buf.external->hash;
+    auto hash = cached.load(std::memory_order_relaxed);
+    if (hash == 0) {
+        hash = details::hash_code_units(external_data(), get_size());
+        cached.store(hash, std::memory_order_relaxed);
+    }
+    return hash;
 }
 
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::external_data(external_buffer* external) noexcept -> char_type*
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::external_data() const noexcept -> char_type*
+{
+    return external_data(rep_.tagged.buf.external);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::external_data(external_buffer* external) noexcept -> char_type*
 {
     return reinterpret_cast<char_type*>(reinterpret_cast<char*>(external)
                                         + sizeof(external_buffer));
 }
 
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::make_literal_size(size_type n) -> size_type
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::inline_data() const noexcept -> char_type*
+{
+    // The first code unit is reserved for the tag and length.
+    return const_cast<char_type*>(rep_.chars) + 1;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::shared_data() const noexcept -> char_type*
 {
-    return (n << 1) | 0;
+    return external_data() + (rep_.tagged.size >> shared_offset_shift);
 }
 
-template<typename CharT, typename Traits>
-inline constexpr auto basic_string<CharT, Traits>::make_external_size(size_type n) -> size_type
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::make_literal_size(size_type n) -> size_type
 {
-    return (n << 1) | 1;
+    return (n << tag_bits) | literal_tag;
 }
 
-template<typename CharT, typename Traits>
-inline constexpr bool basic_string<CharT, Traits>::has_external_buffer() const noexcept
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::make_external_size(size_type n) -> size_type
 {
-    return (size_ & 1) != 0;
+    return (n << tag_bits) | external_tag;
 }
 
-template<typename CharT, typename Traits>
-inline auto basic_string<CharT, Traits>::make_external_buf(pointer data, size_type len) -> external_buffer*
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::make_inline_size(size_type n) -> size_type
 {
-    const auto buf_size = (len + 1) * sizeof(value_type);
-    const auto external = static_cast<external_buffer*>(malloc(sizeof(external_buffer) + buf_size));
-    if (!external)
-        throw std::bad_alloc();
+    return (n << tag_bits) | inline_tag;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::tagged_size() const noexcept -> size_type
+{
+    // Inline strings are written through `chars`, so `tagged` may not be the
+    // active member; read its bytes instead. Strings made in constant
+    // expressions are never inline.
+    if (std::is_constant_evaluated())
+        return rep_.tagged.size;
+    size_type size;
+    std::memcpy(&size, &rep_, sizeof(size));
+    return size;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr bool basic_string<CharT, Traits, Allocator, RefCount>::has_external_buffer() const noexcept
+{
+    return (tagged_size() & tag_mask) == external_tag;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr bool basic_string<CharT, Traits, Allocator, RefCount>::has_inline_buffer() const noexcept
+{
+    return (tagged_size() & tag_mask) == inline_tag;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr bool basic_string<CharT, Traits, Allocator, RefCount>::has_shared_buffer() const noexcept
+{
+    return (tagged_size() & tag_mask) == shared_tag;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr bool basic_string<CharT, Traits, Allocator, RefCount>::is_ref_counted() const noexcept
+{
+    return (tagged_size() & 1) != 0;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string<CharT, Traits, Allocator, RefCount>::init_inline(pointer data, size_type len) noexcept
+{
+    static_assert(sizeof(representation) == sizeof(size_type) + sizeof(buffer));
+    static_assert(inline_capacity <= (inline_size_mask >> tag_bits));
+
+    // The first code unit holds the tag and length, which on little-endian
+    // targets makes them the low-order byte of `tagged.size`. The rest are
+    // zeroed past the null-terminator.
+    rep_.chars[0] = static_cast<char_type>(make_inline_size(len));
+    traits_type::copy(rep_.chars + 1, data, len);
+    std::fill(rep_.chars + 1 + len, std::end(rep_.chars), char_type());
+}
 
-    new (external) external_buffer{};
-    memcpy(external_data(external), data, buf_size);
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr auto basic_string<CharT, Traits, Allocator, RefCount>::external_blocks(size_type len) noexcept -> size_type
+{
+    const auto bytes = sizeof(external_buffer) + (len + 1) * sizeof(value_type);
+    return (bytes + sizeof(external_buffer) - 1) / sizeof(external_buffer);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::allocate_external_buf(size_type capacity,
+                                                                                    const Allocator& alloc) -> external_buffer*
+{
+    block_allocator blocks{alloc};
+    const auto external = block_traits::allocate(blocks, external_blocks(capacity));
+    ::new (static_cast<void*>(external)) external_buffer{capacity, alloc};
+    details::count(details::stat_allocations);
+    details::count(details::stat_allocated_bytes, external_blocks(capacity) * sizeof(external_buffer));
     return external;
 }
 
-template<typename CharT, typename Traits>
-inline void basic_string<CharT, Traits>::copy(const basic_string& other) noexcept
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string<CharT, Traits, Allocator, RefCount>::make_external_buf(pointer data, size_type len,
+                                                                                const Allocator& alloc) -> external_buffer*
 {
-    if (other.has_external_buffer()) {
-        buf_.external = other.buf_.external;
-        buf_.external->ref_count.fetch_add(1);
-    } else {
-        buf_.literal = other.buf_.literal;
+    const auto external = allocate_external_buf(len, alloc);
+    traits_type::copy(external_data(external), data, len);
+    external_data(external)[len] = char_type();
+    return external;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string<CharT, Traits, Allocator, RefCount>::destroy_external_buf(external_buffer* external) noexcept
+{
+    if (external->capacity == mapped_capacity) {
+#if __has_include(<sys/mman.h>)
+        const auto region = *(reinterpret_cast<mapped_region*>(external) - 1);
+        external->~external_buffer();
+        ::munmap(region.base, region.length);
+#endif
+        return;
     }
-    size_ = other.size_;
+
+    // The header owns the allocator, so move it out before destroying the header.
+    block_allocator blocks{std::move(external->allocator)};
+    const auto n = external_blocks(external->capacity);
+    details::count(details::stat_frees);
+    details::count(details::stat_freed_bytes, n * sizeof(external_buffer));
+    external->~external_buffer();
+    block_traits::deallocate(blocks, external, n);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string<CharT, Traits, Allocator, RefCount>::copy(const basic_string& other) noexcept
+{
+    rep_ = other.rep_;
+    if (is_ref_counted()) {
+        RefCount::increment(rep_.tagged.buf.external->ref_count);
+        details::count(details::stat_copies);
+    }
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string<CharT, Traits, Allocator, RefCount>::steal(basic_string& other) noexcept
+{
+    rep_ = other.rep_;
+    other.rep_.tagged = {make_literal_size(0), {&empty_literal_[0]}};
 }
 
-template<typename CharT, typename Traits>
-inline void basic_string<CharT, Traits>::release() noexcept
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline constexpr void basic_string<CharT, Traits, Allocator, RefCount>::release() noexcept
 {
-    if (has_external_buffer()) {
-        const auto refs = buf_.external->ref_count.fetch_sub(1) - 1;
-        if (refs == 0) {
-            buf_.external->~external_buffer();
-            free(buf_.external);
-        }
+    if (is_ref_counted()) {
+        details::count(details::stat_releases);
+        if (RefCount::decrement(rep_.tagged.buf.external->ref_count))
+            destroy_external_buf(rep_.tagged.buf.external);
     }
 }
 
@@ -198,9 +406,11 @@ inline namespace v1 {
 namespace literals {
 
 template<details::literal_string Literal>
-inline constexpr string operator""_is()
+inline constexpr basic_string<typename decltype(Literal)::char_type> operator""_is()
 {
-    return string(details::literal_string_ref{&Literal.data[0], Literal.size});
+    using char_type = typename decltype(Literal)::char_type;
+    return basic_string<char_type>{
+        details::basic_literal_string_ref<char_type>{&Literal.data[0], Literal.size}};
 }
 
 } // namespace literals
@@ -0,0 +1,319 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_BASIC_STRING_BUILDER_IMPL_HPP
+#define TJ_STRING_BASIC_STRING_BUILDER_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string_builder<CharT, Traits, Allocator, RefCount>::basic_string_builder() noexcept(
+    noexcept(Allocator()))
+  : basic_string_builder{Allocator()}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string_builder<CharT, Traits, Allocator, RefCount>::basic_string_builder(
+    const Allocator& alloc) noexcept
+  : buf_{nullptr}
+  , size_{0}
+  , alloc_{alloc}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string_builder<CharT, Traits, Allocator, RefCount>::basic_string_builder(
+    size_type capacity, const Allocator& alloc)
+  : basic_string_builder{alloc}
+{
+    reserve(capacity);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string_builder<CharT, Traits, Allocator, RefCount>::basic_string_builder(
+    basic_string_builder&& other) noexcept
+  : buf_{std::exchange(other.buf_, nullptr)}
+  , size_{std::exchange(other.size_, 0)}
+  , alloc_{other.alloc_}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::operator=(
+    basic_string_builder&& other) noexcept -> basic_string_builder&
+{
+    if (this != &other) {
+        if (buf_)
+            string_type::destroy_external_buf(buf_);
+        buf_ = std::exchange(other.buf_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        alloc_ = other.alloc_;
+    }
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string_builder<CharT, Traits, Allocator, RefCount>::~basic_string_builder()
+{
+    if (buf_)
+        string_type::destroy_external_buf(buf_);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::size() const noexcept -> size_type
+{
+    return size_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::capacity() const noexcept -> size_type
+{
+    return buf_ ? buf_->capacity : 0;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline bool basic_string_builder<CharT, Traits, Allocator, RefCount>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string_builder<CharT, Traits, Allocator, RefCount>::reserve(size_type capacity)
+{
+    if (capacity > this->capacity()) {
+        retired_buffer retired;
+        reallocate(capacity, retired);
+    }
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::append(slice_type s)
+    -> basic_string_builder&
+{
+    if (!s.empty()) {
+        retired_buffer retired;
+        traits_type::copy(grow(s.size(), retired), s.data(), s.size());
+    }
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::append(size_type count,
+                                                                             value_type c)
+    -> basic_string_builder&
+{
+    if (count != 0) {
+        retired_buffer retired;
+        traits_type::assign(grow(count, retired), count, c);
+    }
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string_builder<CharT, Traits, Allocator, RefCount>::push_back(value_type c)
+{
+    retired_buffer retired;
+    traits_type::assign(*grow(1, retired), c);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+template<typename Operation>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::append_with(size_type count,
+                                                                                  Operation op)
+    -> basic_string_builder&
+{
+    retired_buffer retired;
+    const auto written = static_cast<size_type>(op(grow(count, retired), count));
+    size_ -= count - written;
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::operator+=(slice_type s)
+    -> basic_string_builder&
+{
+    return append(s);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::operator+=(value_type c)
+    -> basic_string_builder&
+{
+    push_back(c);
+    return *this;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string_builder<CharT, Traits, Allocator, RefCount>::clear() noexcept
+{
+    size_ = 0;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::view() const noexcept -> slice_type
+{
+    if (!buf_)
+        return {};
+    return {string_type::external_data(buf_), size_};
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::str() && -> string_type
+{
+    if (size_ == 0)
+        return {};
+    if (size_ <= string_type::inline_capacity) {
+        string_type result{string_type::external_data(buf_), size_};
+        clear();
+        return result;
+    }
+
+    string_type::external_data(buf_)[size_] = value_type();
+    details::count_construction(details::stat_external_constructions, size_);
+    string_type result;
+    result.rep_.tagged.size = string_type::make_external_size(std::exchange(size_, 0));
+    result.rep_.tagged.buf.external = std::exchange(buf_, nullptr);
+    return result;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_string_builder<CharT, Traits, Allocator, RefCount>::grow(size_type count,
+                                                                           retired_buffer& retired)
+    -> value_type*
+{
+    const auto needed = size_ + count;
+    if (needed > capacity())
+        reallocate(std::max(needed, 2 * capacity()), retired);
+    return string_type::external_data(buf_) + std::exchange(size_, needed);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline void basic_string_builder<CharT, Traits, Allocator, RefCount>::reallocate(size_type capacity,
+                                                                                 retired_buffer& retired)
+{
+    const auto external = string_type::allocate_external_buf(capacity, alloc_);
+    if (buf_)
+        traits_type::copy(string_type::external_data(external), string_type::external_data(buf_), size_);
+    retired.buf = std::exchange(buf_, external);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_string_builder<CharT, Traits, Allocator, RefCount>::retired_buffer::~retired_buffer()
+{
+    if (buf)
+        string_type::destroy_external_buf(buf);
+}
+
+namespace details {
+
+template<typename Builder, typename... Args>
+inline auto concat(const Args&... args)
+{
+    using string_type = typename Builder::string_type;
+    using slice_type = typename Builder::slice_type;
+    const std::array<slice_type, sizeof...(Args)> parts{slice_type{args}...};
+
+    typename Builder::size_type size = 0;
+    for (const auto& part : parts)
+        size += part.size();
+
+    if (size <= string_type::inline_capacity) {
+        // The result is stored inline, so assemble it on the stack.
+        typename Builder::value_type buf[string_type::inline_capacity + 1];
+        auto out = buf;
+        for (const auto& part : parts)
+            out = std::copy(part.begin(), part.end(), out);
+        return string_type{buf, size};
+    }
+
+    Builder builder{size};
+    for (const auto& part : parts)
+        builder.append(part);
+    return std::move(builder).str();
+}
+
+template<typename Builder, typename R>
+inline auto make_strings(const R& parts)
+{
+    using string_type = typename Builder::string_type;
+    using slice_type = typename Builder::slice_type;
+
+    std::vector<string_type> result;
+    typename Builder::size_type count = 0;
+    typename Builder::size_type size = 0;
+    for (const slice_type part : parts) {
+        ++count;
+        if (part.size() > string_type::inline_capacity)
+            size += part.size() + 1;
+    }
+    result.reserve(count);
+    if (size == 0) {
+        for (const slice_type part : parts)
+            result.emplace_back(part.data(), part.size());
+        return result;
+    }
+
+    // Every long part is followed by a null-terminator, so all of them can
+    // share the buffer of `block`.
+    Builder builder{size};
+    for (const slice_type part : parts) {
+        if (part.size() > string_type::inline_capacity) {
+            builder.append(part);
+            builder.push_back(typename Builder::value_type());
+        }
+    }
+    const auto block = std::move(builder).str();
+
+    typename Builder::size_type offset = 0;
+    for (const slice_type part : parts) {
+        if (part.size() > string_type::inline_capacity) {
+            result.push_back(block.share_substr(offset, part.size()));
+            offset += part.size() + 1;
+        } else {
+            result.emplace_back(part.data(), part.size());
+        }
+    }
+    return result;
+}
+
+} // namespace details
+
+template<typename... Args>
+inline string concat(const Args&... args)
+    requires(std::is_convertible_v<const Args&, slice> && ...)
+{
+    return details::concat<string_builder>(args...);
+}
+
+template<typename... Args>
+inline wstring concat(const Args&... args)
+    requires(sizeof...(Args) != 0 && (std::is_convertible_v<const Args&, wslice> && ...))
+{
+    return details::concat<wstring_builder>(args...);
+}
+
+template<std::ranges::forward_range R>
+inline std::vector<string> make_strings(const R& parts)
+    requires std::is_convertible_v<std::ranges::range_reference_t<const R>, slice>
+{
+    return details::make_strings<string_builder>(parts);
+}
+
+template<std::ranges::forward_range R>
+inline std::vector<wstring> make_strings(const R& parts)
+    requires std::is_convertible_v<std::ranges::range_reference_t<const R>, wslice>
+{
+    return details::make_strings<wstring_builder>(parts);
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_BASIC_STRING_BUILDER_IMPL_HPP)
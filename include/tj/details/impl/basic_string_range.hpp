@@ -9,6 +9,11 @@
 #endif // defined(__cplusplus)
 
 #include <tj/details/basic_string_range.hpp>
+#include <tj/details/search.hpp>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 namespace tj {
 inline namespace v1 {
@@ -69,42 +74,42 @@ template<typename CharT, typename Traits, typename Derived>
 inline constexpr auto basic_string_range<CharT, Traits, Derived>::end() const noexcept
     -> const_iterator
 {
-    return data() + size() + 1;
+    return data() + size();
 }
 
 template<typename CharT, typename Traits, typename Derived>
 inline constexpr auto basic_string_range<CharT, Traits, Derived>::cend() const noexcept
     -> const_iterator
 {
-    return data() + size() + 1;
+    return data() + size();
 }
 
 template<typename CharT, typename Traits, typename Derived>
 inline constexpr auto basic_string_range<CharT, Traits, Derived>::rbegin() const noexcept
     -> const_reverse_iterator
 {
-    return {begin()};
+    return const_reverse_iterator{end()};
 }
 
 template<typename CharT, typename Traits, typename Derived>
 inline constexpr auto basic_string_range<CharT, Traits, Derived>::crbegin() const noexcept
     -> const_reverse_iterator
 {
-    return {begin()};
+    return const_reverse_iterator{end()};
 }
 
 template<typename CharT, typename Traits, typename Derived>
 inline constexpr auto basic_string_range<CharT, Traits, Derived>::rend() const noexcept
     -> const_reverse_iterator
 {
-    return {end()};
+    return const_reverse_iterator{begin()};
 }
 
 template<typename CharT, typename Traits, typename Derived>
 inline constexpr auto basic_string_range<CharT, Traits, Derived>::crend() const noexcept
     -> const_reverse_iterator
 {
-    return {end()};
+    return const_reverse_iterator{begin()};
 }
 
 template<typename CharT, typename Traits, typename Derived>
@@ -120,6 +125,31 @@ inline constexpr auto basic_string_range<CharT, Traits, Derived>::size() const n
 }
 
 
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto basic_string_range<CharT, Traits, Derived>::substr(size_type pos,
+                                                                         size_type count) const
+    -> basic_slice<CharT, Traits>
+{
+    const auto n = size();
+    if (pos > n)
+        throw std::out_of_range("pos");
+    return {data() + pos, std::min(count, n - pos)};
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto basic_string_range<CharT, Traits, Derived>::hash() const noexcept -> size_type
+{
+    return static_cast<const Derived*>(this)->get_hash();
+}
+
+template<typename CharT, typename Traits, typename Derived>
+template<class T>
+inline constexpr int basic_string_range<CharT, Traits, Derived>::compare(T&& rhs) const noexcept
+    requires(std::is_convertible_v<T, basic_slice<CharT, Traits>>)
+{
+    return compare(basic_slice<CharT, Traits>{std::forward<T>(rhs)});
+}
+
 template<typename CharT, typename Traits, typename Derived>
 inline constexpr int
 basic_string_range<CharT, Traits, Derived>::compare(basic_slice<CharT, Traits> rhs) const noexcept
@@ -129,9 +159,22 @@ basic_string_range<CharT, Traits, Derived>::compare(basic_slice<CharT, Traits> r
     if (s1 == 0 && s2 == 0)
         return 0;
 
-    const auto order = traits_type::compare(data(), rhs.data(), std::min(s1, s2));
-    if (order != 0)
-        return order;
+    // Copies and interned strings share their characters, so the common prefix
+    // is trivially equal.
+    if (data() != rhs.data()) {
+        const auto n = std::min(s1, s2);
+        const auto order = [&] {
+            if constexpr (is_byte_string<CharT, Traits>) {
+                if (!std::is_constant_evaluated()) {
+                    return simd::compare(reinterpret_cast<const char*>(data()),
+                                         reinterpret_cast<const char*>(rhs.data()), n);
+                }
+            }
+            return traits_type::compare(data(), rhs.data(), n);
+        }();
+        if (order != 0)
+            return order;
+    }
 
     if (s1 < s2)
         return -1;
@@ -140,6 +183,338 @@ basic_string_range<CharT, Traits, Derived>::compare(basic_slice<CharT, Traits> r
     return 1;
 }
 
+template<typename CharT, typename Traits, typename Derived>
+template<class T>
+inline constexpr bool basic_string_range<CharT, Traits, Derived>::equals(T&& rhs) const noexcept
+    requires(std::is_convertible_v<T, basic_slice<CharT, Traits>>)
+{
+    return equals(basic_slice<CharT, Traits>{std::forward<T>(rhs)});
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool
+basic_string_range<CharT, Traits, Derived>::equals(basic_slice<CharT, Traits> rhs) const noexcept
+{
+    const auto n = size();
+    if (n != rhs.size())
+        return false;
+    if (n == 0 || data() == rhs.data())
+        return true;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            return simd::equal(reinterpret_cast<const char*>(data()),
+                               reinterpret_cast<const char*>(rhs.data()), n);
+        }
+    }
+    return traits_type::compare(data(), rhs.data(), n) == 0;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool
+basic_string_range<CharT, Traits, Derived>::starts_with(basic_slice<CharT, Traits> s) const noexcept
+{
+    return size() >= s.size() && traits_type::compare(data(), s.data(), s.size()) == 0;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool basic_string_range<CharT, Traits, Derived>::starts_with(value_type c) const noexcept
+{
+    return !empty() && traits_type::eq(front(), c);
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool
+basic_string_range<CharT, Traits, Derived>::ends_with(basic_slice<CharT, Traits> s) const noexcept
+{
+    return size() >= s.size()
+           && traits_type::compare(data() + size() - s.size(), s.data(), s.size()) == 0;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool basic_string_range<CharT, Traits, Derived>::ends_with(value_type c) const noexcept
+{
+    return !empty() && traits_type::eq(back(), c);
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool
+basic_string_range<CharT, Traits, Derived>::contains(basic_slice<CharT, Traits> s) const noexcept
+{
+    return find(s) != npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr bool basic_string_range<CharT, Traits, Derived>::contains(value_type c) const noexcept
+{
+    return find(c) != npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find(basic_slice<CharT, Traits> s, size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+    const auto m = s.size();
+    if (pos > n || m > n - pos)
+        return npos;
+    if (m == 0)
+        return pos;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto first = reinterpret_cast<const char*>(data());
+            const auto needle = reinterpret_cast<const char*>(s.data());
+            const auto p = simd::find(first + pos, first + n, needle, needle + m);
+            return p == first + n ? npos : static_cast<size_type>(p - first);
+        }
+    }
+
+    const auto first = data();
+    for (auto i = pos; i <= n - m; ++i) {
+        if (traits_type::eq(first[i], s[0]) && traits_type::compare(first + i, s.data(), m) == 0)
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto basic_string_range<CharT, Traits, Derived>::find(value_type c,
+                                                                       size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+    if (pos >= n)
+        return npos;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto first = reinterpret_cast<const char*>(data());
+            const auto p = simd::find(first + pos, first + n, static_cast<char>(c));
+            return p == first + n ? npos : static_cast<size_type>(p - first);
+        }
+    }
+
+    const auto p = traits_type::find(data() + pos, n - pos, c);
+    return p ? static_cast<size_type>(p - data()) : npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto basic_string_range<CharT, Traits, Derived>::find(pointer s, size_type pos,
+                                                                       size_type count) const noexcept
+    -> size_type
+{
+    return find(basic_slice<CharT, Traits>{s, count}, pos);
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::rfind(basic_slice<CharT, Traits> s, size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+    const auto m = s.size();
+    if (m > n)
+        return npos;
+
+    const auto first = data();
+    for (auto i = std::min(pos, n - m) + 1; i-- > 0;) {
+        if (traits_type::compare(first + i, s.data(), m) == 0)
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto basic_string_range<CharT, Traits, Derived>::rfind(value_type c,
+                                                                        size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+    if (n == 0)
+        return npos;
+    const auto last = std::min(pos, n - 1) + 1;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto first = reinterpret_cast<const char*>(data());
+            const auto p = simd::rfind(first, first + last, static_cast<char>(c));
+            return p == first + last ? npos : static_cast<size_type>(p - first);
+        }
+    }
+
+    for (auto i = last; i-- > 0;) {
+        if (traits_type::eq(data()[i], c))
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto basic_string_range<CharT, Traits, Derived>::rfind(pointer s, size_type pos,
+                                                                        size_type count) const noexcept
+    -> size_type
+{
+    return rfind(basic_slice<CharT, Traits>{s, count}, pos);
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_first_of(basic_slice<CharT, Traits> s,
+                                                          size_type pos) const noexcept -> size_type
+{
+    const auto n = size();
+    if (pos >= n)
+        return npos;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto first = reinterpret_cast<const char*>(data());
+            const auto set = reinterpret_cast<const char*>(s.data());
+            const auto p = simd::find_first_of(first + pos, first + n, set, set + s.size());
+            return p == first + n ? npos : static_cast<size_type>(p - first);
+        }
+    }
+
+    for (auto i = pos; i < n; ++i) {
+        if (traits_type::find(s.data(), s.size(), data()[i]))
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_first_of(value_type c, size_type pos) const noexcept
+    -> size_type
+{
+    return find(c, pos);
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_last_of(basic_slice<CharT, Traits> s,
+                                                         size_type pos) const noexcept -> size_type
+{
+    const auto n = size();
+    if (n == 0 || s.empty())
+        return npos;
+    const auto last = std::min(pos, n - 1) + 1;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto set_first = reinterpret_cast<const char*>(s.data());
+            const byte_set set{set_first, set_first + s.size()};
+            for (auto i = last; i-- > 0;) {
+                if (set.contains(static_cast<char>(data()[i])))
+                    return i;
+            }
+            return npos;
+        }
+    }
+
+    for (auto i = last; i-- > 0;) {
+        if (traits_type::find(s.data(), s.size(), data()[i]))
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_last_of(value_type c, size_type pos) const noexcept
+    -> size_type
+{
+    return rfind(c, pos);
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_first_not_of(basic_slice<CharT, Traits> s,
+                                                              size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto set_first = reinterpret_cast<const char*>(s.data());
+            const byte_set set{set_first, set_first + s.size()};
+            for (auto i = pos; i < n; ++i) {
+                if (!set.contains(static_cast<char>(data()[i])))
+                    return i;
+            }
+            return npos;
+        }
+    }
+
+    for (auto i = pos; i < n; ++i) {
+        if (!traits_type::find(s.data(), s.size(), data()[i]))
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_first_not_of(value_type c,
+                                                              size_type pos) const noexcept
+    -> size_type
+{
+    for (auto i = pos; i < size(); ++i) {
+        if (!traits_type::eq(data()[i], c))
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_last_not_of(basic_slice<CharT, Traits> s,
+                                                             size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+    if (n == 0)
+        return npos;
+    const auto last = std::min(pos, n - 1) + 1;
+
+    if constexpr (is_byte_string<CharT, Traits>) {
+        if (!std::is_constant_evaluated()) {
+            const auto set_first = reinterpret_cast<const char*>(s.data());
+            const byte_set set{set_first, set_first + s.size()};
+            for (auto i = last; i-- > 0;) {
+                if (!set.contains(static_cast<char>(data()[i])))
+                    return i;
+            }
+            return npos;
+        }
+    }
+
+    for (auto i = last; i-- > 0;) {
+        if (!traits_type::find(s.data(), s.size(), data()[i]))
+            return i;
+    }
+    return npos;
+}
+
+template<typename CharT, typename Traits, typename Derived>
+inline constexpr auto
+basic_string_range<CharT, Traits, Derived>::find_last_not_of(value_type c,
+                                                             size_type pos) const noexcept
+    -> size_type
+{
+    const auto n = size();
+    if (n == 0)
+        return npos;
+    for (auto i = std::min(pos, n - 1) + 1; i-- > 0;) {
+        if (!traits_type::eq(data()[i], c))
+            return i;
+    }
+    return npos;
+}
+
 } // namespace details
 } // namespace v1
 } // namespace tj
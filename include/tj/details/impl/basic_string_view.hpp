@@ -26,8 +26,9 @@ inline constexpr basic_string_view<CharT, Traits>::basic_string_view(pointer dat
 {}
 
 template<typename CharT, typename Traits>
+template<typename Allocator, typename RefCount>
 inline constexpr basic_string_view<CharT, Traits>::basic_string_view(
-    const basic_string<CharT, Traits>& s) noexcept
+    const basic_string<CharT, Traits, Allocator, RefCount>& s) noexcept
   : data_{s.data()}
   , size_{s.size()}
 {}
@@ -58,6 +59,12 @@ inline constexpr auto basic_string_view<CharT, Traits>::get_size() const noexcep
     return size_;
 }
 
+template<typename CharT, typename Traits>
+inline constexpr auto basic_string_view<CharT, Traits>::get_hash() const noexcept -> size_type
+{
+    return details::hash_code_units(data_, size_);
+}
+
 } // namespace v1
 } // namespace tj
 
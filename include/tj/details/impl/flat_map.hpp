@@ -0,0 +1,104 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_FLAT_MAP_IMPL_HPP
+#define TJ_STRING_FLAT_MAP_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/flat_map.hpp>
+
+#include <stdexcept>
+#include <tuple>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline T& flat_map<Key, T, Hash, KeyEqual, Allocator>::at(const K& key)
+    requires(details::lookup_key<Hash, KeyEqual, K, key_type>)
+{
+    const auto it = this->find(key);
+    if (it == this->end())
+        throw std::out_of_range("key");
+    return it->second;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline const T& flat_map<Key, T, Hash, KeyEqual, Allocator>::at(const K& key) const
+    requires(details::lookup_key<Hash, KeyEqual, K, key_type>)
+{
+    const auto it = this->find(key);
+    if (it == this->end())
+        throw std::out_of_range("key");
+    return it->second;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+inline T& flat_map<Key, T, Hash, KeyEqual, Allocator>::operator[](const key_type& key)
+{
+    return try_emplace(key).first->second;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+inline T& flat_map<Key, T, Hash, KeyEqual, Allocator>::operator[](key_type&& key)
+{
+    return try_emplace(std::move(key)).first->second;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+template<typename... Args>
+inline auto flat_map<Key, T, Hash, KeyEqual, Allocator>::try_emplace(const key_type& key, Args&&... args)
+    -> std::pair<iterator, bool>
+{
+    const auto [index, inserted] = this->find_or_prepare_insert(key);
+    if (inserted) {
+        this->construct_at(index, std::piecewise_construct, std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    return {this->iterator_at(index), inserted};
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+template<typename... Args>
+inline auto flat_map<Key, T, Hash, KeyEqual, Allocator>::try_emplace(key_type&& key, Args&&... args)
+    -> std::pair<iterator, bool>
+{
+    const auto [index, inserted] = this->find_or_prepare_insert(key);
+    if (inserted) {
+        this->construct_at(index, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    return {this->iterator_at(index), inserted};
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+template<typename M>
+inline auto flat_map<Key, T, Hash, KeyEqual, Allocator>::insert_or_assign(const key_type& key, M&& value)
+    -> std::pair<iterator, bool>
+{
+    const auto result = try_emplace(key, std::forward<M>(value));
+    if (!result.second)
+        result.first->second = std::forward<M>(value);
+    return result;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+template<typename M>
+inline auto flat_map<Key, T, Hash, KeyEqual, Allocator>::insert_or_assign(key_type&& key, M&& value)
+    -> std::pair<iterator, bool>
+{
+    const auto result = try_emplace(std::move(key), std::forward<M>(value));
+    if (!result.second)
+        result.first->second = std::forward<M>(value);
+    return result;
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_FLAT_MAP_IMPL_HPP)
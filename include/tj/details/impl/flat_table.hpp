@@ -0,0 +1,648 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_FLAT_TABLE_IMPL_HPP
+#define TJ_STRING_FLAT_TABLE_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/flat_table.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+inline ctrl_group::ctrl_group(const ctrl_t* ctrl) noexcept
+  : ctrl_{ctrl}
+{}
+
+#if defined(__SSE2__)
+inline std::uint32_t ctrl_group::match(ctrl_t h2) const noexcept
+{
+    const auto ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl_));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+}
+
+inline std::uint32_t ctrl_group::match_empty() const noexcept
+{
+    return match(ctrl_empty);
+}
+
+inline std::uint32_t ctrl_group::match_empty_or_deleted() const noexcept
+{
+    // Both markers are less than the sentinel, and full slots are not.
+    const auto ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl_));
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl)));
+}
+#else
+inline std::uint32_t ctrl_group::match(ctrl_t h2) const noexcept
+{
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i != width; ++i)
+        mask |= std::uint32_t{ctrl_[i] == h2} << i;
+    return mask;
+}
+
+inline std::uint32_t ctrl_group::match_empty() const noexcept
+{
+    return match(ctrl_empty);
+}
+
+inline std::uint32_t ctrl_group::match_empty_or_deleted() const noexcept
+{
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i != width; ++i)
+        mask |= std::uint32_t{ctrl_[i] < ctrl_sentinel} << i;
+    return mask;
+}
+#endif
+
+template<typename Key>
+inline void set_policy<Key>::relocate(value_type* dst, value_type* src) noexcept
+{
+    ::new (static_cast<void*>(dst)) value_type(std::move(*src));
+    src->~value_type();
+}
+
+template<typename Key, typename T>
+inline void map_policy<Key, T>::relocate(value_type* dst, value_type* src) noexcept
+{
+    // The key is const, so it is copied rather than moved; for tj::string
+    // keys that only bumps the ref-count, and cannot throw.
+    ::new (static_cast<void*>(dst)) value_type(src->first, std::move(src->second));
+    src->~value_type();
+}
+
+// flat_table::basic_iterator
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::basic_iterator(
+    const ctrl_t* ctrl, slot* s) noexcept
+  : ctrl_{ctrl}
+  , slot_{s}
+{}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+template<bool OtherConst>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::basic_iterator(
+    const basic_iterator<OtherConst>& other) noexcept
+    requires(Const && !OtherConst)
+  : ctrl_{other.ctrl_}
+  , slot_{other.slot_}
+{}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::skip_free() noexcept
+{
+    while (*ctrl_ < ctrl_sentinel) {
+        ++ctrl_;
+        ++slot_;
+    }
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::operator*() const noexcept
+    -> reference
+{
+    return slot_->value;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::operator->() const noexcept
+    -> pointer
+{
+    return &slot_->value;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::operator++() noexcept
+    -> basic_iterator&
+{
+    ++ctrl_;
+    ++slot_;
+    skip_free();
+    return *this;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::operator++(int) noexcept
+    -> basic_iterator
+{
+    auto result = *this;
+    ++*this;
+    return result;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<bool Const>
+template<bool OtherConst>
+inline bool flat_table<Policy, Hash, KeyEqual, Allocator>::basic_iterator<Const>::operator==(
+    const basic_iterator<OtherConst>& other) const noexcept
+{
+    return ctrl_ == other.ctrl_;
+}
+
+// flat_table
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::flat_table(size_type capacity, const Hash& hash,
+                                                                  const KeyEqual& eq,
+                                                                  const Allocator& alloc)
+  : hash_{hash}
+  , eq_{eq}
+  , alloc_{alloc}
+{
+    reserve(capacity);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::flat_table(const Allocator& alloc)
+  : alloc_{alloc}
+{}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::flat_table(std::initializer_list<value_type> values,
+                                                                  const Hash& hash, const KeyEqual& eq,
+                                                                  const Allocator& alloc)
+  : flat_table{values.size(), hash, eq, alloc}
+{
+    for (const auto& value : values)
+        insert(value);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::flat_table(const flat_table& other)
+  : flat_table{other.size_, other.hash_, other.eq_,
+               std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc_)}
+{
+    for (const auto& value : other)
+        construct_at(prepare_insert(hash_(Policy::key(value))), value);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::flat_table(flat_table&& other) noexcept
+  : ctrl_{std::exchange(other.ctrl_, empty_ctrl_)}
+  , slots_{std::exchange(other.slots_, nullptr)}
+  , capacity_{std::exchange(other.capacity_, 0)}
+  , size_{std::exchange(other.size_, 0)}
+  , growth_left_{std::exchange(other.growth_left_, 0)}
+  , hash_{other.hash_}
+  , eq_{other.eq_}
+  , alloc_{other.alloc_}
+{}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::operator=(const flat_table& other)
+    -> flat_table&
+{
+    if (this != &other) {
+        flat_table copy{other};
+        swap(copy);
+    }
+    return *this;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::operator=(flat_table&& other) noexcept
+    -> flat_table&
+{
+    if (this != &other) {
+        flat_table moved{std::move(other)};
+        swap(moved);
+    }
+    return *this;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline flat_table<Policy, Hash, KeyEqual, Allocator>::~flat_table()
+{
+    destroy();
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::begin() noexcept -> iterator
+{
+    iterator it{ctrl_, slots_};
+    it.skip_free();
+    return it;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::begin() const noexcept -> const_iterator
+{
+    return cbegin();
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::cbegin() const noexcept -> const_iterator
+{
+    const_iterator it{ctrl_, slots_};
+    it.skip_free();
+    return it;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::end() noexcept -> iterator
+{
+    return iterator_at(capacity_);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::end() const noexcept -> const_iterator
+{
+    return iterator_at(capacity_);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::cend() const noexcept -> const_iterator
+{
+    return iterator_at(capacity_);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline bool flat_table<Policy, Hash, KeyEqual, Allocator>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::size() const noexcept -> size_type
+{
+    return size_;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::capacity() const noexcept -> size_type
+{
+    return capacity_;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::clear() noexcept
+{
+    for (size_type i = 0; i != capacity_; ++i) {
+        if (ctrl_[i] >= 0)
+            slots_[i].value.~value_type();
+    }
+    if (capacity_ != 0)
+        std::memset(ctrl_, ctrl_empty, capacity_);
+    size_ = 0;
+    growth_left_ = capacity_ - capacity_ / 8;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::insert(const value_type& value)
+    -> std::pair<iterator, bool>
+{
+    const auto [index, inserted] = find_or_prepare_insert(Policy::key(value));
+    if (inserted)
+        construct_at(index, value);
+    return {iterator_at(index), inserted};
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::insert(value_type&& value)
+    -> std::pair<iterator, bool>
+{
+    const auto [index, inserted] = find_or_prepare_insert(Policy::key(value));
+    if (inserted)
+        construct_at(index, std::move(value));
+    return {iterator_at(index), inserted};
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename... Args>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::emplace(Args&&... args)
+    -> std::pair<iterator, bool>
+{
+    // The key is only known once the element is constructed.
+    return insert(value_type(std::forward<Args>(args)...));
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::erase(const_iterator pos) -> iterator
+{
+    const auto index = static_cast<size_type>(pos.ctrl_ - ctrl_);
+    erase_at(index);
+    auto next = iterator_at(index);
+    next.skip_free();
+    return next;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::erase(const K& key) -> size_type
+    requires(lookup_key<Hash, KeyEqual, K, key_type> && !std::is_convertible_v<const K&, const_iterator>)
+{
+    const auto index = find_index(key, hash_(key));
+    if (index == npos)
+        return 0;
+    erase_at(index);
+    return 1;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::swap(flat_table& other) noexcept
+{
+    using std::swap;
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+    swap(hash_, other.hash_);
+    swap(eq_, other.eq_);
+    swap(alloc_, other.alloc_);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::find(const K& key) -> iterator
+    requires(lookup_key<Hash, KeyEqual, K, key_type>)
+{
+    const auto index = find_index(key, hash_(key));
+    return index == npos ? end() : iterator_at(index);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::find(const K& key) const -> const_iterator
+    requires(lookup_key<Hash, KeyEqual, K, key_type>)
+{
+    const auto index = find_index(key, hash_(key));
+    return index == npos ? end() : iterator_at(index);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline bool flat_table<Policy, Hash, KeyEqual, Allocator>::contains(const K& key) const
+    requires(lookup_key<Hash, KeyEqual, K, key_type>)
+{
+    return find_index(key, hash_(key)) != npos;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::count(const K& key) const -> size_type
+    requires(lookup_key<Hash, KeyEqual, K, key_type>)
+{
+    return contains(key) ? 1 : 0;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::reserve(size_type n)
+{
+    const auto capacity = capacity_for(n);
+    if (capacity > capacity_)
+        rehash(capacity);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::hash_function() const -> hasher
+{
+    return hash_;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::key_eq() const -> key_equal
+{
+    return eq_;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::get_allocator() const noexcept -> allocator_type
+{
+    return alloc_;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::find_index(const K& key,
+                                                                       std::size_t hash) const
+    -> size_type
+{
+    if (capacity_ == 0)
+        return npos;
+
+    // Groups are probed in triangular steps, which visits every group once
+    // since their number is a power of two.
+    const auto group_mask = capacity_ / ctrl_group::width - 1;
+    auto group = (hash >> 7) & group_mask;
+    for (size_type step = 1;; ++step) {
+        const auto first = group * ctrl_group::width;
+        const ctrl_group g{ctrl_ + first};
+        for (auto mask = g.match(h2(hash)); mask != 0; mask &= mask - 1) {
+            const auto index = first + std::countr_zero(mask);
+            if (eq_(Policy::key(slots_[index].value), key))
+                return index;
+        }
+        if (g.match_empty() != 0)
+            return npos;
+        group = (group + step) & group_mask;
+    }
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::find_or_prepare_insert(const K& key)
+    -> std::pair<size_type, bool>
+{
+    const auto hash = hash_(key);
+    const auto index = find_index(key, hash);
+    if (index != npos)
+        return {index, false};
+    return {prepare_insert(hash), true};
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+template<typename... Args>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::construct_at(size_type index, Args&&... args)
+{
+    try {
+        ::new (static_cast<void*>(&slots_[index].value)) value_type(std::forward<Args>(args)...);
+    } catch (...) {
+        // Give the slot that `prepare_insert` claimed back. A tombstone stays
+        // one, since probe sequences may pass through it.
+        set_ctrl(index, claimed_ctrl_);
+        if (claimed_ctrl_ == ctrl_empty)
+            ++growth_left_;
+        --size_;
+        throw;
+    }
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::iterator_at(size_type index) noexcept -> iterator
+{
+    return {ctrl_ + index, slots_ + index};
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::iterator_at(size_type index) const noexcept
+    -> const_iterator
+{
+    return {ctrl_ + index, slots_ + index};
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::value_at(size_type index) noexcept -> value_type&
+{
+    return slots_[index].value;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::prepare_insert(std::size_t hash) -> size_type
+{
+    auto index = find_free(hash);
+    if (growth_left_ == 0 && ctrl_[index] != ctrl_deleted) {
+        grow();
+        index = find_free(hash);
+    }
+    claimed_ctrl_ = ctrl_[index];
+    if (claimed_ctrl_ == ctrl_empty)
+        --growth_left_;
+    set_ctrl(index, h2(hash));
+    ++size_;
+    return index;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::find_free(std::size_t hash) const noexcept
+    -> size_type
+{
+    if (capacity_ == 0)
+        return 0; // the sentinel, which is neither empty nor deleted
+
+    const auto group_mask = capacity_ / ctrl_group::width - 1;
+    auto group = (hash >> 7) & group_mask;
+    for (size_type step = 1;; ++step) {
+        const auto first = group * ctrl_group::width;
+        if (const auto mask = ctrl_group{ctrl_ + first}.match_empty_or_deleted())
+            return first + std::countr_zero(mask);
+        group = (group + step) & group_mask;
+    }
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::set_ctrl(size_type index, ctrl_t ctrl) noexcept
+{
+    ctrl_[index] = ctrl;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::erase_at(size_type index) noexcept
+{
+    slots_[index].value.~value_type();
+    --size_;
+
+    // Lookups stop at a group with an empty slot, so no probe sequence passes
+    // through such a group and the slot can simply become empty again.
+    const auto first = index / ctrl_group::width * ctrl_group::width;
+    if (ctrl_group{ctrl_ + first}.match_empty() != 0) {
+        set_ctrl(index, ctrl_empty);
+        ++growth_left_;
+    } else {
+        set_ctrl(index, ctrl_deleted);
+    }
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::grow()
+{
+    // Mostly tombstones are cleaned up in place; otherwise the table doubles.
+    if (capacity_ != 0 && size_ <= capacity_ * 7 / 16)
+        rehash(capacity_);
+    else
+        rehash(std::max(capacity_ * 2, ctrl_group::width));
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::rehash(size_type capacity)
+{
+    slot_allocator slot_alloc{alloc_};
+    ctrl_allocator ctrl_alloc{alloc_};
+    const auto slots = slot_traits::allocate(slot_alloc, capacity);
+    ctrl_t* ctrl;
+    try {
+        ctrl = ctrl_traits::allocate(ctrl_alloc, capacity + 1);
+    } catch (...) {
+        slot_traits::deallocate(slot_alloc, slots, capacity);
+        throw;
+    }
+    std::memset(ctrl, ctrl_empty, capacity);
+    ctrl[capacity] = ctrl_sentinel;
+
+    const auto old_ctrl = std::exchange(ctrl_, ctrl);
+    const auto old_slots = std::exchange(slots_, slots);
+    const auto old_capacity = std::exchange(capacity_, capacity);
+    for (size_type i = 0; i != old_capacity; ++i) {
+        if (old_ctrl[i] < 0)
+            continue;
+        const auto hash = hash_(Policy::key(old_slots[i].value));
+        const auto index = find_free(hash);
+        set_ctrl(index, h2(hash));
+        Policy::relocate(&slots_[index].value, &old_slots[i].value);
+    }
+    growth_left_ = capacity_ - capacity_ / 8 - size_;
+
+    if (old_capacity != 0) {
+        slot_traits::deallocate(slot_alloc, old_slots, old_capacity);
+        ctrl_traits::deallocate(ctrl_alloc, old_ctrl, old_capacity + 1);
+    }
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline void flat_table<Policy, Hash, KeyEqual, Allocator>::destroy() noexcept
+{
+    if (capacity_ == 0)
+        return;
+    clear();
+    slot_allocator slot_alloc{alloc_};
+    ctrl_allocator ctrl_alloc{alloc_};
+    slot_traits::deallocate(slot_alloc, slots_, capacity_);
+    ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_ + 1);
+    ctrl_ = empty_ctrl_;
+    slots_ = nullptr;
+    capacity_ = 0;
+    growth_left_ = 0;
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline ctrl_t flat_table<Policy, Hash, KeyEqual, Allocator>::h2(std::size_t hash) noexcept
+{
+    return static_cast<ctrl_t>(hash & 0x7f);
+}
+
+template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+inline auto flat_table<Policy, Hash, KeyEqual, Allocator>::capacity_for(size_type n) noexcept -> size_type
+{
+    if (n == 0)
+        return 0;
+    // The smallest power of two, of at least one group, that is at most 7/8 full.
+    return std::max(std::bit_ceil(n + (n + 6) / 7), ctrl_group::width);
+}
+
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_FLAT_TABLE_IMPL_HPP)
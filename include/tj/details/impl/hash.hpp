@@ -0,0 +1,117 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_HASH_IMPL_HPP
+#define TJ_STRING_HASH_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/hash.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+namespace tj {
+inline namespace v1 {
+
+template<typename CharT, typename Traits>
+template<typename Derived>
+inline constexpr std::size_t basic_hash<CharT, Traits>::operator()(
+    const details::basic_string_range<CharT, Traits, Derived>& s) const noexcept
+{
+    return s.hash();
+}
+
+template<typename CharT, typename Traits>
+inline constexpr std::size_t
+basic_hash<CharT, Traits>::operator()(basic_slice<CharT, Traits> s) const noexcept
+{
+    return s.hash();
+}
+
+namespace details {
+
+inline constexpr std::uint64_t hash_k0 = 0x9e3779b97f4a7c15;
+inline constexpr std::uint64_t hash_k1 = 0xc2b2ae3d27d4eb4f;
+
+/// Packs up to one word of code units, the first one in the low-order bits.
+template<typename CharT>
+inline constexpr std::uint64_t hash_load(const CharT* data, std::size_t n) noexcept
+{
+    using unit = std::make_unsigned_t<CharT>;
+    constexpr auto bits = sizeof(CharT) * 8;
+
+    if constexpr (sizeof(CharT) == 1 && std::endian::native == std::endian::little) {
+        if (!std::is_constant_evaluated() && n == 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            return word;
+        }
+    }
+
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        word |= std::uint64_t{static_cast<unit>(data[i])} << (i * bits);
+    return word;
+}
+
+template<typename CharT>
+inline constexpr std::size_t hash_code_units(const CharT* data, std::size_t size) noexcept
+{
+    static_assert(sizeof(CharT) <= sizeof(std::uint64_t));
+    constexpr std::size_t units_per_word = sizeof(std::uint64_t) / sizeof(CharT);
+
+    auto h = hash_k0 ^ (size * hash_k1);
+    for (; size >= units_per_word; data += units_per_word, size -= units_per_word)
+        h = std::rotl(h ^ (hash_load(data, units_per_word) * hash_k1), 31) * hash_k0;
+    if (size != 0)
+        h = std::rotl(h ^ (hash_load(data, size) * hash_k1), 31) * hash_k0;
+
+    // Final avalanche, from MurmurHash3
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+}
+
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+namespace std {
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+struct hash<tj::basic_string<CharT, Traits, Allocator, RefCount>> {
+    constexpr size_t
+    operator()(const tj::basic_string<CharT, Traits, Allocator, RefCount>& s) const noexcept
+    {
+        return s.hash();
+    }
+};
+
+template<typename CharT, typename Traits>
+struct hash<tj::basic_string_view<CharT, Traits>> {
+    constexpr size_t operator()(const tj::basic_string_view<CharT, Traits>& s) const noexcept
+    {
+        return s.hash();
+    }
+};
+
+template<typename CharT, typename Traits>
+struct hash<tj::basic_slice<CharT, Traits>> {
+    constexpr size_t operator()(const tj::basic_slice<CharT, Traits>& s) const noexcept
+    {
+        return s.hash();
+    }
+};
+
+} // namespace std
+
+#endif // !defined(TJ_STRING_HASH_IMPL_HPP)
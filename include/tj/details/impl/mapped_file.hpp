@@ -0,0 +1,88 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_MAPPED_FILE_IMPL_HPP
+#define TJ_STRING_MAPPED_FILE_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/mapped_file.hpp>
+
+#if __has_include(<sys/mman.h>)
+
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <system_error>
+#    include <unistd.h>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+inline string file_mapping::map(const char* path)
+{
+    using external_buffer = string::external_buffer;
+    using mapped_region = string::mapped_region;
+
+    struct file {
+        int fd;
+        ~file() { ::close(fd); }
+    };
+
+    const file f{::open(path, O_RDONLY | O_CLOEXEC)};
+    if (f.fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+
+    struct stat st;
+    if (::fstat(f.fd, &st) != 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (size == 0)
+        return {};
+
+    // Reserve a page for the header in front of the file, and room for the
+    // null-terminator behind it. The remainder of the file's last page reads
+    // as zeros, and so does the anonymous page behind files that fill theirs.
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto length = page + (size + page) / page * page;
+    const auto base = static_cast<char*>(
+        ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (base == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), path);
+    if (::mmap(base + page, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, f.fd, 0) == MAP_FAILED) {
+        const auto error = errno;
+        ::munmap(base, length);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+
+    const auto external = reinterpret_cast<external_buffer*>(base + page) - 1;
+    const auto region = reinterpret_cast<mapped_region*>(external) - 1;
+    ::new (static_cast<void*>(region)) mapped_region{base, length};
+    ::new (static_cast<void*>(external)) external_buffer{string::mapped_capacity, {}};
+
+    string result;
+    result.rep_.tagged.size = string::make_external_size(size);
+    result.rep_.tagged.buf.external = external;
+    if (size <= string::inline_capacity)
+        return string{result.data(), size};
+    details::count_construction(details::stat_external_constructions, size);
+    return result;
+}
+
+} // namespace details
+
+inline string map_file(const std::filesystem::path& path)
+{
+    return details::file_mapping::map(path.c_str());
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // __has_include(<sys/mman.h>)
+
+#endif // !defined(TJ_STRING_MAPPED_FILE_IMPL_HPP)
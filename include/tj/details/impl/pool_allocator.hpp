@@ -0,0 +1,125 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_POOL_ALLOCATOR_IMPL_HPP
+#define TJ_STRING_POOL_ALLOCATOR_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/pool_allocator.hpp>
+
+#include <bit>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+/// Set when the cache of the thread has been destroyed, so that strings
+/// destroyed later during thread exit free their buffers directly.
+inline thread_local bool pool_cache_destroyed = false;
+
+inline pool_cache::~pool_cache()
+{
+    for (std::size_t c = 0; c != class_count; ++c) {
+        for (auto block = lists_[c].head; block;) {
+            const auto next = block->next;
+            ::operator delete(block, min_block << c);
+            block = next;
+        }
+    }
+    pool_cache_destroyed = true;
+}
+
+inline pool_cache* pool_cache::local() noexcept
+{
+    if (pool_cache_destroyed)
+        return nullptr;
+    thread_local pool_cache cache;
+    return &cache;
+}
+
+inline std::size_t pool_cache::size_class(std::size_t bytes) noexcept
+{
+    return bytes <= min_block ? 0 : std::bit_width(bytes - 1) - std::bit_width(min_block - 1);
+}
+
+inline void* pool_cache::allocate(std::size_t bytes)
+{
+    if (bytes > max_block)
+        return ::operator new(bytes);
+
+    const auto c = size_class(bytes);
+    if (const auto cache = local()) {
+        auto& list = cache->lists_[c];
+        if (const auto block = list.head) {
+            list.head = block->next;
+            --list.count;
+            return block;
+        }
+    }
+    return ::operator new(min_block << c);
+}
+
+inline void pool_cache::deallocate(void* p, std::size_t bytes) noexcept
+{
+    if (bytes > max_block) {
+        ::operator delete(p, bytes);
+        return;
+    }
+
+    const auto c = size_class(bytes);
+    if (const auto cache = local()) {
+        auto& list = cache->lists_[c];
+        if (list.count < max_cached_bytes / (min_block << c)) {
+            list.head = ::new (p) free_block{list.head};
+            ++list.count;
+            return;
+        }
+    }
+    ::operator delete(p, min_block << c);
+}
+
+} // namespace details
+
+template<typename T>
+template<typename U>
+inline pool_allocator<T>::pool_allocator(const pool_allocator<U>&) noexcept
+{}
+
+template<typename T>
+inline T* pool_allocator<T>::allocate(std::size_t n)
+{
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return std::allocator<T>{}.allocate(n);
+    } else {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(details::pool_cache::allocate(n * sizeof(T)));
+    }
+}
+
+template<typename T>
+inline void pool_allocator<T>::deallocate(T* p, std::size_t n) noexcept
+{
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        std::allocator<T>{}.deallocate(p, n);
+    else
+        details::pool_cache::deallocate(p, n * sizeof(T));
+}
+
+template<typename T>
+template<typename U>
+inline bool pool_allocator<T>::operator==(const pool_allocator<U>&) const noexcept
+{
+    return true;
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_POOL_ALLOCATOR_IMPL_HPP)
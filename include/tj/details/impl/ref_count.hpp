@@ -0,0 +1,44 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_REF_COUNT_IMPL_HPP
+#define TJ_STRING_REF_COUNT_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/ref_count.hpp>
+
+#include <atomic>
+
+namespace tj {
+inline namespace v1 {
+
+inline void atomic_ref_count::increment(value_type& count) noexcept
+{
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline bool atomic_ref_count::decrement(value_type& count) noexcept
+{
+    if (count.fetch_sub(1, std::memory_order_release) != 1)
+        return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+inline void local_ref_count::increment(value_type& count) noexcept
+{
+    ++count;
+}
+
+inline bool local_ref_count::decrement(value_type& count) noexcept
+{
+    return --count == 0;
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_REF_COUNT_IMPL_HPP)
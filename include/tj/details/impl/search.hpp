@@ -0,0 +1,361 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_SEARCH_IMPL_HPP
+#define TJ_STRING_SEARCH_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/search.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+inline byte_set::byte_set(const char* first, const char* last) noexcept
+{
+    for (; first != last; ++first) {
+        const auto b = static_cast<unsigned char>(*first);
+        bits_[b >> 6] |= std::uint64_t{1} << (b & 63);
+    }
+}
+
+inline bool byte_set::contains(char c) const noexcept
+{
+    const auto b = static_cast<unsigned char>(c);
+    return (bits_[b >> 6] >> (b & 63)) & 1;
+}
+
+namespace simd {
+
+#if defined(__AVX2__)
+inline std::uint32_t equal_mask(__m256i lhs, __m256i rhs) noexcept
+{
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs, rhs)));
+}
+
+inline __m256i load32(const char* p) noexcept
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+#endif
+
+#if defined(__SSE2__)
+inline std::uint32_t equal_mask(__m128i lhs, __m128i rhs) noexcept
+{
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs)));
+}
+
+inline __m128i load16(const char* p) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+#endif
+
+inline const char* find(const char* first, const char* last, char c) noexcept
+{
+#if defined(__AVX2__)
+    const auto c32 = _mm256_set1_epi8(c);
+    for (; last - first >= 32; first += 32) {
+        if (const auto mask = equal_mask(load32(first), c32))
+            return first + std::countr_zero(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    const auto c16 = _mm_set1_epi8(c);
+    for (; last - first >= 16; first += 16) {
+        if (const auto mask = equal_mask(load16(first), c16))
+            return first + std::countr_zero(mask);
+    }
+    for (; first != last; ++first) {
+        if (*first == c)
+            return first;
+    }
+    return last;
+#else
+    const auto p = std::memchr(first, c, static_cast<std::size_t>(last - first));
+    return p ? static_cast<const char*>(p) : last;
+#endif
+}
+
+inline const char* rfind(const char* first, const char* last, char c) noexcept
+{
+    auto end = last;
+#if defined(__AVX2__)
+    const auto c32 = _mm256_set1_epi8(c);
+    for (; end - first >= 32; end -= 32) {
+        if (const auto mask = equal_mask(load32(end - 32), c32))
+            return end - 1 - std::countl_zero(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    const auto c16 = _mm_set1_epi8(c);
+    for (; end - first >= 16; end -= 16) {
+        // Only the low 16 bits of the mask are used.
+        if (const auto mask = equal_mask(load16(end - 16), c16) << 16)
+            return end - 1 - std::countl_zero(mask);
+    }
+#endif
+    while (end != first) {
+        if (*--end == c)
+            return end;
+    }
+    return last;
+}
+
+inline const char* find(const char* first, const char* last, const char* s_first,
+                        const char* s_last) noexcept
+{
+    const auto m = s_last - s_first;
+    if (m == 1)
+        return find(first, last, *s_first);
+    if (last - first < m)
+        return last;
+
+    // Candidate positions are those where both the first and the last byte of
+    // the needle match; only those are compared in full.
+    const auto candidate = [=](const char* p) {
+        return std::memcmp(p + 1, s_first + 1, static_cast<std::size_t>(m - 2)) == 0;
+    };
+    const auto end = last - m + 1; // one past the last possible match
+
+#if defined(__AVX2__)
+    const auto head32 = _mm256_set1_epi8(s_first[0]);
+    const auto tail32 = _mm256_set1_epi8(s_last[-1]);
+    for (; end - first >= 32; first += 32) {
+        auto mask = equal_mask(load32(first), head32) & equal_mask(load32(first + m - 1), tail32);
+        for (; mask != 0; mask &= mask - 1) {
+            const auto p = first + std::countr_zero(mask);
+            if (candidate(p))
+                return p;
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    const auto head16 = _mm_set1_epi8(s_first[0]);
+    const auto tail16 = _mm_set1_epi8(s_last[-1]);
+    for (; end - first >= 16; first += 16) {
+        auto mask = equal_mask(load16(first), head16) & equal_mask(load16(first + m - 1), tail16);
+        for (; mask != 0; mask &= mask - 1) {
+            const auto p = first + std::countr_zero(mask);
+            if (candidate(p))
+                return p;
+        }
+    }
+#endif
+    for (; first != end; ++first) {
+        if (first[0] == s_first[0] && first[m - 1] == s_last[-1] && candidate(first))
+            return first;
+    }
+    return last;
+}
+
+inline const char* find_first_of(const char* first, const char* last, const char* s_first,
+                                 const char* s_last) noexcept
+{
+    const auto m = s_last - s_first;
+    if (m == 0)
+        return last;
+    if (m == 1)
+        return find(first, last, *s_first);
+
+#if defined(__SSE2__)
+    // Small sets, like delimiters, are compared against every byte of a block.
+    constexpr std::ptrdiff_t max_simd_set = 8;
+    if (m <= max_simd_set) {
+#    if defined(__AVX2__)
+        __m256i set32[max_simd_set];
+        for (std::ptrdiff_t i = 0; i < m; ++i)
+            set32[i] = _mm256_set1_epi8(s_first[i]);
+        for (; last - first >= 32; first += 32) {
+            const auto block = load32(first);
+            auto matches = _mm256_cmpeq_epi8(block, set32[0]);
+            for (std::ptrdiff_t i = 1; i < m; ++i)
+                matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, set32[i]));
+            if (const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(matches)))
+                return first + std::countr_zero(mask);
+        }
+#    endif
+        __m128i set16[max_simd_set];
+        for (std::ptrdiff_t i = 0; i < m; ++i)
+            set16[i] = _mm_set1_epi8(s_first[i]);
+        for (; last - first >= 16; first += 16) {
+            const auto block = load16(first);
+            auto matches = _mm_cmpeq_epi8(block, set16[0]);
+            for (std::ptrdiff_t i = 1; i < m; ++i)
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, set16[i]));
+            if (const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(matches)))
+                return first + std::countr_zero(mask);
+        }
+    }
+#endif
+
+    const byte_set set{s_first, s_last};
+    for (; first != last; ++first) {
+        if (set.contains(*first))
+            return first;
+    }
+    return last;
+}
+
+template<typename Word>
+inline Word load_word(const char* p) noexcept
+{
+    Word w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+#if defined(__AVX2__)
+/// `true` if the 128 bytes at `lhs` and `rhs` are equal.
+inline bool equal128(const char* lhs, const char* rhs) noexcept
+{
+    const auto eq0 = _mm256_cmpeq_epi8(load32(lhs), load32(rhs));
+    const auto eq1 = _mm256_cmpeq_epi8(load32(lhs + 32), load32(rhs + 32));
+    const auto eq2 = _mm256_cmpeq_epi8(load32(lhs + 64), load32(rhs + 64));
+    const auto eq3 = _mm256_cmpeq_epi8(load32(lhs + 96), load32(rhs + 96));
+    const auto eq = _mm256_and_si256(_mm256_and_si256(eq0, eq1), _mm256_and_si256(eq2, eq3));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq)) == 0xffffffff;
+}
+#elif defined(__SSE2__)
+/// `true` if the 64 bytes at `lhs` and `rhs` are equal.
+inline bool equal64(const char* lhs, const char* rhs) noexcept
+{
+    const auto eq0 = _mm_cmpeq_epi8(load16(lhs), load16(rhs));
+    const auto eq1 = _mm_cmpeq_epi8(load16(lhs + 16), load16(rhs + 16));
+    const auto eq2 = _mm_cmpeq_epi8(load16(lhs + 32), load16(rhs + 32));
+    const auto eq3 = _mm_cmpeq_epi8(load16(lhs + 48), load16(rhs + 48));
+    const auto eq = _mm_and_si128(_mm_and_si128(eq0, eq1), _mm_and_si128(eq2, eq3));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(eq)) == 0xffff;
+}
+#endif
+
+// Without AVX2 at compile time, long ranges are left to the C library, which
+// selects the widest vectors the CPU supports at run time.
+#if !defined(__AVX2__)
+inline constexpr std::size_t libc_compare_threshold = 256;
+#endif
+
+inline std::size_t mismatch(const char* lhs, const char* rhs, std::size_t n) noexcept
+{
+    // Long equal prefixes are skipped a few blocks at a time; the block with
+    // the difference is then searched one vector at a time.
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; n - i >= 128 && equal128(lhs + i, rhs + i); i += 128) {
+    }
+    for (; n - i >= 32; i += 32) {
+        if (const auto mask = ~equal_mask(load32(lhs + i), load32(rhs + i)))
+            return i + std::countr_zero(mask);
+    }
+#elif defined(__SSE2__)
+    for (; n - i >= 64 && equal64(lhs + i, rhs + i); i += 64) {
+    }
+#endif
+#if defined(__SSE2__)
+    for (; n - i >= 16; i += 16) {
+        if (const auto mask = ~equal_mask(load16(lhs + i), load16(rhs + i)) & 0xffff)
+            return i + std::countr_zero(mask);
+    }
+#endif
+    for (; n - i >= 8; i += 8) {
+        if (const auto diff = load_word<std::uint64_t>(lhs + i) ^ load_word<std::uint64_t>(rhs + i)) {
+            const auto bits = std::endian::native == std::endian::little ? std::countr_zero(diff)
+                                                                         : std::countl_zero(diff);
+            return i + bits / 8;
+        }
+    }
+    if (n - i >= 4 && load_word<std::uint32_t>(lhs + i) == load_word<std::uint32_t>(rhs + i))
+        i += 4;
+    for (; i != n; ++i) {
+        if (lhs[i] != rhs[i])
+            return i;
+    }
+    return n;
+}
+
+inline bool equal(const char* lhs, const char* rhs, std::size_t n) noexcept
+{
+#if !defined(__AVX2__)
+    if (n >= libc_compare_threshold)
+        return std::memcmp(lhs, rhs, n) == 0;
+#endif
+
+    // The tail is compared as one vector overlapping the previous one.
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; n - i >= 128; i += 128) {
+        if (!equal128(lhs + i, rhs + i))
+            return false;
+    }
+    if (n >= 32) {
+        for (; n - i > 32; i += 32) {
+            if (equal_mask(load32(lhs + i), load32(rhs + i)) != 0xffffffff)
+                return false;
+        }
+        return equal_mask(load32(lhs + n - 32), load32(rhs + n - 32)) == 0xffffffff;
+    }
+#elif defined(__SSE2__)
+    for (; n - i >= 64; i += 64) {
+        if (!equal64(lhs + i, rhs + i))
+            return false;
+    }
+#endif
+#if defined(__SSE2__)
+    if (n >= 16) {
+        for (; n - i > 16; i += 16) {
+            if (equal_mask(load16(lhs + i), load16(rhs + i)) != 0xffff)
+                return false;
+        }
+        return equal_mask(load16(lhs + n - 16), load16(rhs + n - 16)) == 0xffff;
+    }
+#endif
+    if (n >= 8) {
+        for (; n - i > 8; i += 8) {
+            if (load_word<std::uint64_t>(lhs + i) != load_word<std::uint64_t>(rhs + i))
+                return false;
+        }
+        return load_word<std::uint64_t>(lhs + n - 8) == load_word<std::uint64_t>(rhs + n - 8);
+    }
+    if (n >= 4) {
+        return load_word<std::uint32_t>(lhs) == load_word<std::uint32_t>(rhs)
+               && load_word<std::uint32_t>(lhs + n - 4) == load_word<std::uint32_t>(rhs + n - 4);
+    }
+    for (; i != n; ++i) {
+        if (lhs[i] != rhs[i])
+            return false;
+    }
+    return true;
+}
+
+inline int compare(const char* lhs, const char* rhs, std::size_t n) noexcept
+{
+#if !defined(__AVX2__)
+    if (n >= libc_compare_threshold)
+        return std::memcmp(lhs, rhs, n);
+#endif
+    const auto i = mismatch(lhs, rhs, n);
+    if (i == n)
+        return 0;
+    return static_cast<unsigned char>(lhs[i]) < static_cast<unsigned char>(rhs[i]) ? -1 : 1;
+}
+
+} // namespace simd
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_SEARCH_IMPL_HPP)
@@ -0,0 +1,143 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_SERIALIZATION_IMPL_HPP
+#define TJ_STRING_SERIALIZATION_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/serialization.hpp>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+inline constexpr std::array<char, 8> serialization_magic = {'t', 'j', 's', 1, 0, 0, 0, 0};
+inline constexpr std::size_t serialization_header_size = 16;
+inline constexpr std::size_t serialization_alignment = 8;
+
+inline std::array<char, 8> store_u64(std::uint64_t value) noexcept
+{
+    std::array<char, 8> bytes;
+    for (auto& byte : bytes) {
+        byte = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    return bytes;
+}
+
+inline std::uint64_t load_u64(const char* bytes) noexcept
+{
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; --i)
+        value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    return value;
+}
+
+/// Returns the size of an entry of `len` characters, including its length
+/// and padding.
+inline constexpr std::size_t serialized_entry_size(std::size_t len) noexcept
+{
+    const auto unpadded = sizeof(std::uint64_t) + len + 1;
+    return (unpadded + serialization_alignment - 1) / serialization_alignment * serialization_alignment;
+}
+
+/// Returns the number of entries of `blob`, after checking its header and
+/// that its offset table is within it.
+inline std::size_t serialized_count(slice blob)
+{
+    const auto data = blob.data();
+    const auto size = blob.size();
+    if (size < serialization_header_size
+        || !std::equal(serialization_magic.begin(), serialization_magic.end(), data))
+        throw std::invalid_argument("blob");
+
+    const auto count = load_u64(data + serialization_magic.size());
+    if (count > (size - serialization_header_size) / sizeof(std::uint64_t))
+        throw std::invalid_argument("blob");
+    return static_cast<std::size_t>(count);
+}
+
+/// Calls `f(offset, len)` with the offset of the characters of each of the
+/// `count` entries of `blob`, after checking that the entry is within it.
+template<typename F>
+inline void for_each_serialized(slice blob, std::size_t count, F f)
+{
+    const auto data = blob.data();
+    const auto size = blob.size();
+    for (std::size_t i = 0; i != count; ++i) {
+        const auto offset = load_u64(data + serialization_header_size + i * sizeof(std::uint64_t));
+        if (offset > size || size - offset < serialized_entry_size(0))
+            throw std::invalid_argument("blob");
+        const auto len = load_u64(data + offset);
+        if (len >= size - offset - sizeof(std::uint64_t)
+            || data[offset + sizeof(std::uint64_t) + len] != '\0')
+            throw std::invalid_argument("blob");
+        f(static_cast<std::size_t>(offset + sizeof(std::uint64_t)), static_cast<std::size_t>(len));
+    }
+}
+
+} // namespace details
+
+template<std::ranges::forward_range R>
+inline string serialize(const R& strings)
+    requires std::is_convertible_v<std::ranges::range_reference_t<const R>, slice>
+{
+    std::size_t count = 0;
+    std::size_t size = 0;
+    for (const slice s : strings) {
+        ++count;
+        size += details::serialized_entry_size(s.size());
+    }
+    const auto table_size = count * sizeof(std::uint64_t);
+
+    string_builder builder{details::serialization_header_size + table_size + size};
+    builder.append(slice{details::serialization_magic.data(), details::serialization_magic.size()});
+    builder.append(slice{details::store_u64(count).data(), sizeof(std::uint64_t)});
+
+    auto offset = details::serialization_header_size + table_size;
+    for (const slice s : strings) {
+        builder.append(slice{details::store_u64(offset).data(), sizeof(std::uint64_t)});
+        offset += details::serialized_entry_size(s.size());
+    }
+
+    for (const slice s : strings) {
+        builder.append(slice{details::store_u64(s.size()).data(), sizeof(std::uint64_t)});
+        builder.append(s);
+        builder.append(details::serialized_entry_size(s.size()) - sizeof(std::uint64_t) - s.size(), '\0');
+    }
+    return std::move(builder).str();
+}
+
+inline std::vector<slice> deserialize_slices(slice blob)
+{
+    const auto count = details::serialized_count(blob);
+    std::vector<slice> result;
+    result.reserve(count);
+    details::for_each_serialized(blob, count, [&](std::size_t offset, std::size_t len) {
+        result.emplace_back(blob.data() + offset, len);
+    });
+    return result;
+}
+
+inline std::vector<string> deserialize(const string& blob)
+{
+    const auto count = details::serialized_count(blob);
+    std::vector<string> result;
+    result.reserve(count);
+    details::for_each_serialized(blob, count, [&](std::size_t offset, std::size_t len) {
+        result.push_back(blob.share_substr(offset, len));
+    });
+    return result;
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_SERIALIZATION_IMPL_HPP)
@@ -0,0 +1,289 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_SORT_IMPL_HPP
+#define TJ_STRING_SORT_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/sort.hpp>
+
+#include <tj/details/search.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+namespace sort {
+
+inline std::uint64_t load_key(const char* data, std::size_t size, std::size_t depth) noexcept
+{
+    if (depth >= size)
+        return 0;
+
+    unsigned char bytes[8] = {};
+    std::memcpy(bytes, data + depth, std::min<std::size_t>(size - depth, 8));
+    std::uint64_t key;
+    std::memcpy(&key, bytes, 8);
+    if constexpr (std::endian::native == std::endian::little) {
+#if defined(__GNUC__)
+        key = __builtin_bswap64(key);
+#else
+        key = 0;
+        for (const auto b : bytes)
+            key = (key << 8) | b;
+#endif
+    }
+    return key;
+}
+
+inline int compare_from(const char* lhs, std::size_t lhs_size, const char* rhs, std::size_t rhs_size,
+                        std::size_t offset) noexcept
+{
+    const auto n = std::min(lhs_size, rhs_size);
+    if (n > offset) {
+        if (const auto result = simd::compare(lhs + offset, rhs + offset, n - offset))
+            return result;
+    }
+    return lhs_size < rhs_size ? -1 : lhs_size > rhs_size ? 1 : 0;
+}
+
+inline bool less(const entry& lhs, const entry& rhs, std::size_t depth) noexcept
+{
+    if (lhs.key != rhs.key)
+        return lhs.key < rhs.key;
+    // Strings that end within their keys can only differ in the number of
+    // zeros they end with, which `compare_from` orders by size.
+    return compare_from(lhs.data, lhs.size, rhs.data, rhs.size, depth + 8) < 0;
+}
+
+inline bool work_queue::push(entry* first, entry* last, std::size_t depth, int budget) noexcept
+{
+    {
+        const std::lock_guard lock{mutex_};
+        try {
+            ranges_.push_back({first, last, depth, budget});
+        } catch (const std::bad_alloc&) {
+            return false;
+        }
+        ++pending_;
+    }
+    cv_.notify_one();
+    return true;
+}
+
+inline void work_queue::work()
+{
+    std::unique_lock lock{mutex_};
+    for (;;) {
+        cv_.wait(lock, [this] { return !ranges_.empty() || pending_ == 0; });
+        if (ranges_.empty())
+            return;
+
+        const auto r = ranges_.back();
+        ranges_.pop_back();
+        lock.unlock();
+        multikey_quicksort(r.first, r.last, r.depth, r.budget, this);
+        lock.lock();
+        if (--pending_ == 0)
+            cv_.notify_all();
+    }
+}
+
+inline void insertion_sort(entry* first, entry* last, std::size_t depth) noexcept
+{
+    for (auto i = first + 1; i < last; ++i) {
+        auto e = *i;
+        auto j = i;
+        for (; j != first && less(e, j[-1], depth); --j)
+            *j = j[-1];
+        *j = e;
+    }
+}
+
+inline void multikey_quicksort(entry* first, entry* last, std::size_t depth, int budget, work_queue* queue)
+{
+    const auto sort_range = [&](entry* f, entry* l) {
+        if (queue != nullptr && static_cast<std::size_t>(l - f) >= parallel_limit
+            && queue->push(f, l, depth, budget - 1))
+            return;
+        multikey_quicksort(f, l, depth, budget - 1, queue);
+    };
+
+    while (static_cast<std::size_t>(last - first) > insertion_limit) {
+        if (budget <= 0) {
+            std::sort(first, last, [depth](const entry& lhs, const entry& rhs) {
+                return less(lhs, rhs, depth);
+            });
+            return;
+        }
+
+        const auto a = first->key;
+        const auto b = first[(last - first) / 2].key;
+        const auto c = last[-1].key;
+        const auto pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        // Partition into [first, lt) < pivot, [lt, gt) == pivot and
+        // [gt, last) > pivot.
+        auto lt = first;
+        auto gt = last;
+        for (auto i = first; i < gt;) {
+            if (i->key < pivot)
+                std::swap(*lt++, *i++);
+            else if (i->key > pivot)
+                std::swap(*i, *--gt);
+            else
+                ++i;
+        }
+        sort_range(first, lt);
+        sort_range(gt, last);
+
+        // The strings that end within the pivot are equal but for trailing
+        // zeros, and come before the others. The rest go on with the next
+        // 8 bytes.
+        const auto offset = depth + 8;
+        const auto rest = std::partition(lt, gt, [offset](const entry& e) { return e.size <= offset; });
+        std::sort(lt, rest, [](const entry& lhs, const entry& rhs) { return lhs.size < rhs.size; });
+        for (auto e = rest; e != gt; ++e)
+            e->key = load_key(e->data, e->size, offset);
+        first = rest;
+        last = gt;
+        depth = offset;
+    }
+    insertion_sort(first, last, depth);
+}
+
+template<typename F>
+inline void for_chunks(unsigned threads, std::size_t n, F f) noexcept
+{
+    const auto chunk = (n + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    auto begin = chunk;
+    try {
+        workers.reserve(threads - 1);
+        for (; begin < n; begin += chunk)
+            workers.emplace_back([&f, begin, end = std::min(n, begin + chunk)] { f(begin, end); });
+    } catch (...) {
+        // The chunks that got no thread are done by this one, only slower.
+    }
+    f(0, std::min(n, chunk));
+    if (begin < n)
+        f(begin, n);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+template<std::random_access_iterator It>
+inline void sort_strings(It first, It last, unsigned threads)
+{
+    const auto n = static_cast<std::size_t>(last - first);
+    if (n < 2)
+        return;
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, n / parallel_limit + 1));
+
+    std::vector<entry> entries(n);
+    for_chunks(threads, n, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i != end; ++i) {
+            const slice s = first[static_cast<std::iter_difference_t<It>>(i)];
+            entries[i] = {load_key(s.data(), s.size(), 0), s.data(), s.size(), i};
+        }
+    });
+
+    const auto budget = 2 * static_cast<int>(std::bit_width(n));
+    work_queue queue;
+    if (threads > 1 && queue.push(entries.data(), entries.data() + n, 0, budget))
+        for_chunks(threads, threads, [&queue](std::size_t, std::size_t) { queue.work(); });
+    else
+        multikey_quicksort(entries.data(), entries.data() + n, 0, budget, nullptr);
+
+    // Position i takes the string at entries[i].index. Apply the permutation
+    // in place by following its cycles, marking each position done by
+    // pointing it at itself, so that only one string is held aside at a time.
+    using difference_type = std::iter_difference_t<It>;
+    for (std::size_t i = 0; i != n; ++i) {
+        if (entries[i].index == i)
+            continue;
+        std::iter_value_t<It> held = std::ranges::iter_move(first + static_cast<difference_type>(i));
+        auto j = i;
+        for (auto k = entries[j].index; k != i; k = entries[j].index) {
+            first[static_cast<difference_type>(j)] = std::ranges::iter_move(first + static_cast<difference_type>(k));
+            entries[j].index = j;
+            j = k;
+        }
+        first[static_cast<difference_type>(j)] = std::move(held);
+        entries[j].index = j;
+    }
+}
+
+} // namespace sort
+} // namespace details
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_sort_key<CharT, Traits, Allocator, RefCount>::basic_sort_key() noexcept
+  : prefix_{0}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline basic_sort_key<CharT, Traits, Allocator, RefCount>::basic_sort_key(string_type s) noexcept
+  : prefix_{prefix_of(s)}
+  , str_{std::move(s)}
+{}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline auto basic_sort_key<CharT, Traits, Allocator, RefCount>::str() const noexcept -> const string_type&
+{
+    return str_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline std::uint64_t basic_sort_key<CharT, Traits, Allocator, RefCount>::prefix() const noexcept
+{
+    return prefix_;
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline std::uint64_t basic_sort_key<CharT, Traits, Allocator, RefCount>::prefix_of(slice_type s) noexcept
+{
+    return details::sort::load_key(reinterpret_cast<const char*>(s.data()), s.size(), 0);
+}
+
+template<typename CharT, typename Traits, typename Allocator, typename RefCount>
+inline int basic_sort_key<CharT, Traits, Allocator, RefCount>::compare(const basic_sort_key& lhs,
+                                                                       std::uint64_t rhs_prefix,
+                                                                       slice_type rhs) noexcept
+{
+    if (lhs.prefix_ != rhs_prefix)
+        return lhs.prefix_ < rhs_prefix ? -1 : 1;
+    const slice_type s = lhs.str_;
+    return details::sort::compare_from(reinterpret_cast<const char*>(s.data()), s.size(),
+                                       reinterpret_cast<const char*>(rhs.data()), rhs.size(), 8);
+}
+
+template<std::random_access_iterator It>
+inline void sort_strings(It first, It last)
+    requires std::is_convertible_v<std::iter_reference_t<It>, slice>
+{
+    details::sort::sort_strings(first, last, 1);
+}
+
+template<std::random_access_iterator It>
+inline void parallel_sort_strings(It first, It last, unsigned threads)
+    requires std::is_convertible_v<std::iter_reference_t<It>, slice>
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    details::sort::sort_strings(first, last, threads);
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_SORT_IMPL_HPP)
@@ -0,0 +1,140 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_STATS_IMPL_HPP
+#define TJ_STRING_STATS_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/stats.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+/// The counters of live threads, and the sum of those of exited threads.
+struct stats_counters::registry {
+    std::mutex mutex;
+    stats_counters* head = nullptr;
+    std::array<std::uint64_t, stat_count> retired{};
+};
+
+/// Set when the counters of the thread have been destroyed, so that strings
+/// destroyed later during thread exit count into the registry directly.
+inline thread_local bool stats_counters_destroyed = false;
+
+inline stats_counters::stats_counters() noexcept
+{
+    auto& r = global();
+    const std::lock_guard lock{r.mutex};
+    next_ = r.head;
+    if (next_)
+        next_->prev_ = this;
+    r.head = this;
+}
+
+inline stats_counters::~stats_counters()
+{
+    auto& r = global();
+    {
+        const std::lock_guard lock{r.mutex};
+        for (std::size_t i = 0; i != stat_count; ++i)
+            r.retired[i] += values_[i].load(std::memory_order_relaxed);
+        if (prev_)
+            prev_->next_ = next_;
+        else
+            r.head = next_;
+        if (next_)
+            next_->prev_ = prev_;
+    }
+    stats_counters_destroyed = true;
+}
+
+inline auto stats_counters::global() noexcept -> registry&
+{
+    // Never destroyed, since threads may exit after static destructors ran.
+    static registry* const r = new registry;
+    return *r;
+}
+
+inline stats_counters* stats_counters::local() noexcept
+{
+    if (stats_counters_destroyed)
+        return nullptr;
+    thread_local stats_counters counters;
+    return &counters;
+}
+
+inline void stats_counters::add(stat_counter counter, std::uint64_t n) noexcept
+{
+    if (const auto counters = local()) {
+        auto& value = counters->values_[counter];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    } else {
+        auto& r = global();
+        const std::lock_guard lock{r.mutex};
+        r.retired[counter] += n;
+    }
+}
+
+inline string_stats stats_counters::snapshot()
+{
+    auto& r = global();
+    std::array<std::uint64_t, stat_count> values;
+    {
+        const std::lock_guard lock{r.mutex};
+        values = r.retired;
+        for (auto counters = r.head; counters; counters = counters->next_) {
+            for (std::size_t i = 0; i != stat_count; ++i)
+                values[i] += counters->values_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    string_stats result;
+    result.allocations = values[stat_allocations];
+    result.frees = values[stat_frees];
+    result.allocated_bytes = values[stat_allocated_bytes];
+    result.freed_bytes = values[stat_freed_bytes];
+    result.copies = values[stat_copies];
+    result.releases = values[stat_releases];
+    result.literal_constructions = values[stat_literal_constructions];
+    result.inline_constructions = values[stat_inline_constructions];
+    result.external_constructions = values[stat_external_constructions];
+    result.shared_constructions = values[stat_shared_constructions];
+    std::copy_n(values.begin() + stat_length_histogram, result.length_histogram.size(),
+                result.length_histogram.begin());
+    return result;
+}
+
+inline void count(stat_counter counter, std::uint64_t n) noexcept
+{
+    if constexpr (stats_enabled)
+        stats_counters::add(counter, n);
+}
+
+inline void count_construction(stat_counter kind, std::size_t len) noexcept
+{
+    if constexpr (stats_enabled) {
+        stats_counters::add(kind, 1);
+        const auto bucket = std::min<std::size_t>(std::bit_width(len), stat_count - stat_length_histogram - 1);
+        stats_counters::add(static_cast<stat_counter>(stat_length_histogram + bucket), 1);
+    }
+}
+
+} // namespace details
+
+inline string_stats stats()
+{
+    return details::stats_counters::snapshot();
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_STATS_IMPL_HPP)
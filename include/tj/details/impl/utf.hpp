@@ -0,0 +1,652 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_UTF_IMPL_HPP
+#define TJ_STRING_UTF_IMPL_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/utf.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+#if defined(TJ_STRING_UTF8_DISPATCH)
+#    include <immintrin.h>
+#endif
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+namespace utf {
+
+inline std::size_t ascii_prefix(const char* s, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(v)))
+            return i + std::countr_zero(mask);
+    }
+#endif
+    while (i != n && static_cast<unsigned char>(s[i]) < 0x80)
+        ++i;
+    return i;
+}
+
+inline std::size_t ascii_prefix(const char16_t* s, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const auto high = _mm_set1_epi16(static_cast<short>(0xff80));
+    for (; i + 8 <= n; i += 8) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const auto ascii = _mm_cmpeq_epi16(_mm_and_si128(v, high), _mm_setzero_si128());
+        if (const auto mask = static_cast<unsigned>(~_mm_movemask_epi8(ascii) & 0xffff))
+            return i + std::countr_zero(mask) / 2;
+    }
+#endif
+    while (i != n && s[i] < 0x80)
+        ++i;
+    return i;
+}
+
+inline std::size_t ascii_prefix(const char32_t* s, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const auto high = _mm_set1_epi32(static_cast<int>(0xffffff80));
+    for (; i + 4 <= n; i += 4) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const auto ascii = _mm_cmpeq_epi32(_mm_and_si128(v, high), _mm_setzero_si128());
+        if (const auto mask = static_cast<unsigned>(~_mm_movemask_epi8(ascii) & 0xffff))
+            return i + std::countr_zero(mask) / 4;
+    }
+#endif
+    while (i != n && s[i] < 0x80)
+        ++i;
+    return i;
+}
+
+template<typename To, typename From>
+inline To* copy_ascii(const From* s, std::size_t n, To* out) noexcept
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    if constexpr (sizeof(From) == 1 && sizeof(To) == 2) {
+        for (; i + 16 <= n; i += 16) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            const auto zero = _mm_setzero_si128();
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(v, zero));
+        }
+    } else if constexpr (sizeof(From) == 1 && sizeof(To) == 4) {
+        for (; i + 16 <= n; i += 16) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            const auto zero = _mm_setzero_si128();
+            const auto lo = _mm_unpacklo_epi8(v, zero);
+            const auto hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), _mm_unpackhi_epi16(hi, zero));
+        }
+    } else if constexpr (sizeof(From) == 2 && sizeof(To) == 1) {
+        for (; i + 16 <= n; i += 16) {
+            const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    for (; i != n; ++i)
+        out[i] = static_cast<To>(s[i]);
+    return out + n;
+}
+
+[[noreturn]] inline void invalid()
+{
+    throw std::invalid_argument("invalid code point");
+}
+
+inline std::size_t try_decode(const char* s, std::size_t n, std::size_t i, char32_t& c) noexcept
+{
+    const auto lead = static_cast<unsigned char>(s[i]);
+    if (lead < 0x80) {
+        c = lead;
+        return 1;
+    }
+
+    std::size_t len;
+    char32_t min;
+    if ((lead & 0xe0) == 0xc0) {
+        len = 2;
+        c = lead & 0x1f;
+        min = 0x80;
+    } else if ((lead & 0xf0) == 0xe0) {
+        len = 3;
+        c = lead & 0x0f;
+        min = 0x800;
+    } else if ((lead & 0xf8) == 0xf0) {
+        len = 4;
+        c = lead & 0x07;
+        min = 0x10000;
+    } else {
+        return 0;
+    }
+    if (n - i < len)
+        return 0;
+
+    for (std::size_t k = 1; k != len; ++k) {
+        const auto b = static_cast<unsigned char>(s[i + k]);
+        if ((b & 0xc0) != 0x80)
+            return 0;
+        c = (c << 6) | (b & 0x3f);
+    }
+    // Reject overlong encodings, surrogates and values beyond Unicode.
+    if (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+        return 0;
+    return len;
+}
+
+inline char32_t decode(const char* s, std::size_t n, std::size_t& i)
+{
+    char32_t c;
+    const auto len = try_decode(s, n, i, c);
+    if (len == 0)
+        invalid();
+    i += len;
+    return c;
+}
+
+inline char32_t decode_validated(const char* s, std::size_t& i) noexcept
+{
+    const auto byte = [s](std::size_t k) { return static_cast<char32_t>(static_cast<unsigned char>(s[k])); };
+    const auto lead = byte(i);
+    char32_t c;
+    if (lead < 0xe0) {
+        c = ((lead & 0x1f) << 6) | (byte(i + 1) & 0x3f);
+        i += 2;
+    } else if (lead < 0xf0) {
+        c = ((lead & 0x0f) << 12) | ((byte(i + 1) & 0x3f) << 6) | (byte(i + 2) & 0x3f);
+        i += 3;
+    } else {
+        c = ((lead & 0x07) << 18) | ((byte(i + 1) & 0x3f) << 12) | ((byte(i + 2) & 0x3f) << 6)
+            | (byte(i + 3) & 0x3f);
+        i += 4;
+    }
+    return c;
+}
+
+inline char32_t decode(const char16_t* s, std::size_t n, std::size_t& i)
+{
+    const char32_t u = s[i];
+    if (u < 0xd800 || u > 0xdfff) {
+        ++i;
+        return u;
+    }
+    if (u > 0xdbff || n - i < 2 || s[i + 1] < 0xdc00 || s[i + 1] > 0xdfff)
+        invalid();
+    const char32_t low = s[i + 1];
+    i += 2;
+    return 0x10000 + ((u - 0xd800) << 10) + (low - 0xdc00);
+}
+
+inline char32_t decode(const char32_t* s, std::size_t, std::size_t& i)
+{
+    const auto c = s[i];
+    if (c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+        invalid();
+    ++i;
+    return c;
+}
+
+template<typename To>
+inline std::size_t encoded_size(char32_t c) noexcept
+{
+    if constexpr (sizeof(To) == 1)
+        return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+    else if constexpr (sizeof(To) == 2)
+        return c < 0x10000 ? 1 : 2;
+    else
+        return 1;
+}
+
+inline char* encode(char32_t c, char* out) noexcept
+{
+    if (c < 0x80) {
+        *out++ = static_cast<char>(c);
+    } else if (c < 0x800) {
+        *out++ = static_cast<char>(0xc0 | (c >> 6));
+        *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+        *out++ = static_cast<char>(0xe0 | (c >> 12));
+        *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+        *out++ = static_cast<char>(0xf0 | (c >> 18));
+        *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+        *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    }
+    return out;
+}
+
+inline char16_t* encode(char32_t c, char16_t* out) noexcept
+{
+    if (c < 0x10000) {
+        *out++ = static_cast<char16_t>(c);
+    } else {
+        c -= 0x10000;
+        *out++ = static_cast<char16_t>(0xd800 + (c >> 10));
+        *out++ = static_cast<char16_t>(0xdc00 + (c & 0x3ff));
+    }
+    return out;
+}
+
+inline char32_t* encode(char32_t c, char32_t* out) noexcept
+{
+    *out++ = c;
+    return out;
+}
+
+template<typename To, typename From>
+inline std::size_t transcoded_size(const From* s, std::size_t n)
+{
+    if constexpr (std::is_same_v<From, char>) {
+        // Validating with the vector kernel lets `transcode` decode without
+        // checking. Every code point takes one UTF-32 code unit, and one
+        // UTF-16 code unit unless it has a four-byte sequence.
+        const auto& kernels = utf8_kernels_for_cpu();
+        if (!kernels.validate(s, n, nullptr))
+            invalid();
+        auto size = kernels.count(s, n);
+        if constexpr (sizeof(To) == 2) {
+            for (std::size_t i = 0; i != n; ++i)
+                size += static_cast<unsigned char>(s[i]) >= 0xf0;
+        }
+        return size;
+    }
+
+    std::size_t size = 0;
+    std::size_t i = 0;
+    while (i != n) {
+        if (static_cast<char32_t>(s[i]) < 0x80) {
+            const auto ascii = ascii_prefix(s + i, n - i);
+            size += ascii;
+            i += ascii;
+        } else {
+            size += encoded_size<To>(decode(s, n, i));
+        }
+    }
+    return size;
+}
+
+template<typename To, typename From>
+inline void transcode(const From* s, std::size_t n, To* out)
+{
+    std::size_t i = 0;
+    while (i != n) {
+        if (static_cast<char32_t>(s[i]) < 0x80) {
+            const auto ascii = ascii_prefix(s + i, n - i);
+            out = copy_ascii(s + i, ascii, out);
+            i += ascii;
+        } else if constexpr (std::is_same_v<From, char>) {
+            out = encode(decode_validated(s, i), out);
+        } else {
+            out = encode(decode(s, n, i), out);
+        }
+    }
+}
+
+template<typename To, typename From>
+inline basic_string<To> transcode(basic_slice<From> s)
+{
+    const auto size = transcoded_size<To>(s.data(), s.size());
+    if (size <= basic_string<To>::inline_capacity) {
+        To buf[basic_string<To>::inline_capacity + 1];
+        transcode(s.data(), s.size(), buf);
+        return basic_string<To>{buf, size};
+    }
+
+    basic_string_builder<To> builder{size};
+    builder.append_with(size, [&](To* out, std::size_t) {
+        transcode(s.data(), s.size(), out);
+        return size;
+    });
+    return std::move(builder).str();
+}
+
+
+inline bool validate_scalar(const char* s, std::size_t n, char* out) noexcept
+{
+    std::size_t i = 0;
+    while (i != n) {
+        if (static_cast<unsigned char>(s[i]) < 0x80) {
+            i += ascii_prefix(s + i, n - i);
+        } else {
+            char32_t c;
+            const auto len = try_decode(s, n, i, c);
+            if (len == 0)
+                return false;
+            i += len;
+        }
+    }
+    if (out != nullptr && n != 0)
+        std::memcpy(out, s, n);
+    return true;
+}
+
+inline std::size_t count_scalar(const char* s, std::size_t n) noexcept
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i != n; ++i)
+        count += (static_cast<unsigned char>(s[i]) & 0xc0) != 0x80;
+    return count;
+}
+
+#if defined(TJ_STRING_UTF8_DISPATCH)
+
+// The vector kernels check each byte together with the three bytes before it,
+// as described by Keiser and Lemire in "Validating UTF-8 in less than one
+// instruction per byte". Three table lookups, on the high and low nibble of
+// the previous byte and the high nibble of the current one, give a set of
+// errors that the pair of bytes may be part of. An error remains if all three
+// agree, except that a continuation byte that should be the third or fourth
+// of a sequence is only valid if the pair claims it is two continuations.
+namespace utf8_error {
+
+inline constexpr std::uint8_t too_short = 1 << 0;      // 11______ 0_______, 11______ 11______
+inline constexpr std::uint8_t too_long = 1 << 1;       // 0_______ 10______
+inline constexpr std::uint8_t overlong_3 = 1 << 2;     // 11100000 100_____
+inline constexpr std::uint8_t too_large = 1 << 3;      // 11110100 1001____, 11110100 101_____
+inline constexpr std::uint8_t surrogate = 1 << 4;      // 11101101 101_____
+inline constexpr std::uint8_t overlong_2 = 1 << 5;     // 1100000_ 10______
+inline constexpr std::uint8_t too_large_1000 = 1 << 6; // 11110101+ 1000____
+inline constexpr std::uint8_t overlong_4 = 1 << 6;     // 11110000 1000____
+inline constexpr std::uint8_t two_conts = 1 << 7;      // 10______ 10______
+inline constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+// Indexed by the high nibble of the previous byte.
+alignas(16) inline constexpr std::uint8_t byte_1_high[16] = {
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+    two_conts, two_conts, two_conts, two_conts,
+    too_short | overlong_2,
+    too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4};
+
+// Indexed by the low nibble of the previous byte.
+alignas(16) inline constexpr std::uint8_t byte_1_low[16] = {
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000};
+
+// Indexed by the high nibble of the current byte.
+alignas(16) inline constexpr std::uint8_t byte_2_high[16] = {
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_short, too_short, too_short, too_short};
+
+// Subtracting these with saturation leaves a non-zero byte if a sequence is
+// cut off at the end of a vector.
+alignas(32) inline constexpr std::uint8_t incomplete_limit[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1};
+
+} // namespace utf8_error
+
+[[gnu::target("sse4.2,popcnt")]] inline __m128i sse4_table(const std::uint8_t* table) noexcept
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+}
+
+[[gnu::target("sse4.2,popcnt")]] inline __m128i utf8_errors_sse4(__m128i input, __m128i prev_input) noexcept
+{
+    const auto prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    const auto prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    const auto prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+    const auto nibble = _mm_set1_epi8(0x0f);
+    const auto byte_1_high = _mm_shuffle_epi8(sse4_table(utf8_error::byte_1_high),
+                                              _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const auto byte_1_low = _mm_shuffle_epi8(sse4_table(utf8_error::byte_1_low), _mm_and_si128(prev1, nibble));
+    const auto byte_2_high = _mm_shuffle_epi8(sse4_table(utf8_error::byte_2_high),
+                                              _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const auto special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    const auto third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    const auto fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    const auto must_be_continuation = _mm_and_si128(_mm_or_si128(third, fourth),
+                                                    _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(must_be_continuation, special);
+}
+
+[[gnu::target("sse4.2,popcnt")]] inline bool validate_sse4(const char* s, std::size_t n, char* out) noexcept
+{
+    const auto limit = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8_error::incomplete_limit + 16));
+    auto prev = _mm_setzero_si128();
+    auto error = _mm_setzero_si128();
+    auto incomplete = _mm_setzero_si128();
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (out != nullptr)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), input);
+        if (_mm_movemask_epi8(input) == 0) {
+            // ASCII only needs the previous vector to end with a whole sequence.
+            error = _mm_or_si128(error, incomplete);
+        } else {
+            error = _mm_or_si128(error, utf8_errors_sse4(input, prev));
+            incomplete = _mm_subs_epu8(input, limit);
+        }
+        prev = input;
+    }
+
+    // The rest is padded with at least one NUL, which ends any sequence that
+    // is cut off, so the check needs no special case for the end of `s`.
+    alignas(16) char rest[16] = {};
+    std::memcpy(rest, s + i, n - i);
+    if (out != nullptr)
+        std::memcpy(out + i, s + i, n - i);
+    const auto input = _mm_load_si128(reinterpret_cast<const __m128i*>(rest));
+    error = _mm_or_si128(error, utf8_errors_sse4(input, prev));
+    return _mm_testz_si128(error, error) != 0;
+}
+
+[[gnu::target("sse4.2,popcnt")]] inline std::size_t count_sse4(const char* s, std::size_t n) noexcept
+{
+    // Continuation bytes are the signed bytes below -64.
+    const auto continuation = _mm_set1_epi8(-65);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const auto lead = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, continuation)));
+        count += static_cast<std::size_t>(std::popcount(lead));
+    }
+    return count + count_scalar(s + i, n - i);
+}
+
+[[gnu::target("avx2,popcnt")]] inline __m256i avx2_table(const std::uint8_t* table) noexcept
+{
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+[[gnu::target("avx2,popcnt")]] inline __m256i utf8_errors_avx2(__m256i input, __m256i prev_input) noexcept
+{
+    // The bytes before the first lane are the last ones of the previous vector.
+    const auto shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    const auto prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    const auto prev2 = _mm256_alignr_epi8(input, shifted, 14);
+    const auto prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+    const auto nibble = _mm256_set1_epi8(0x0f);
+    const auto byte_1_high = _mm256_shuffle_epi8(avx2_table(utf8_error::byte_1_high),
+                                                 _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const auto byte_1_low = _mm256_shuffle_epi8(avx2_table(utf8_error::byte_1_low), _mm256_and_si256(prev1, nibble));
+    const auto byte_2_high = _mm256_shuffle_epi8(avx2_table(utf8_error::byte_2_high),
+                                                 _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const auto special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    const auto third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    const auto fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    const auto must_be_continuation = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                                       _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must_be_continuation, special);
+}
+
+[[gnu::target("avx2,popcnt")]] inline bool validate_avx2(const char* s, std::size_t n, char* out) noexcept
+{
+    const auto limit = _mm256_load_si256(reinterpret_cast<const __m256i*>(utf8_error::incomplete_limit));
+    auto prev = _mm256_setzero_si256();
+    auto error = _mm256_setzero_si256();
+    auto incomplete = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        if (out != nullptr)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), input);
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, incomplete);
+        } else {
+            error = _mm256_or_si256(error, utf8_errors_avx2(input, prev));
+            incomplete = _mm256_subs_epu8(input, limit);
+        }
+        prev = input;
+    }
+
+    alignas(32) char rest[32] = {};
+    std::memcpy(rest, s + i, n - i);
+    if (out != nullptr)
+        std::memcpy(out + i, s + i, n - i);
+    const auto input = _mm256_load_si256(reinterpret_cast<const __m256i*>(rest));
+    error = _mm256_or_si256(error, utf8_errors_avx2(input, prev));
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+[[gnu::target("avx2,popcnt")]] inline std::size_t count_avx2(const char* s, std::size_t n) noexcept
+{
+    const auto continuation = _mm256_set1_epi8(-65);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        const auto lead = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, continuation)));
+        count += static_cast<std::size_t>(std::popcount(lead));
+    }
+    return count + count_scalar(s + i, n - i);
+}
+
+#endif // defined(TJ_STRING_UTF8_DISPATCH)
+
+inline const utf8_kernels& utf8_kernels_for_cpu() noexcept
+{
+#if defined(TJ_STRING_UTF8_DISPATCH)
+    static const utf8_kernels& kernels = []() -> const utf8_kernels& {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+            return avx2_kernels;
+        if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+            return sse4_kernels;
+        return scalar_kernels;
+    }();
+    return kernels;
+#else
+    return scalar_kernels;
+#endif
+}
+
+} // namespace utf
+} // namespace details
+
+inline u16string to_utf16(slice s)
+{
+    return details::utf::transcode<char16_t>(s);
+}
+
+inline u16string to_utf16(u32slice s)
+{
+    return details::utf::transcode<char16_t>(s);
+}
+
+inline u32string to_utf32(slice s)
+{
+    return details::utf::transcode<char32_t>(s);
+}
+
+inline u32string to_utf32(u16slice s)
+{
+    return details::utf::transcode<char32_t>(s);
+}
+
+inline string to_utf8(u16slice s)
+{
+    return details::utf::transcode<char>(s);
+}
+
+inline string to_utf8(u32slice s)
+{
+    return details::utf::transcode<char>(s);
+}
+
+inline bool is_valid_utf8(slice s) noexcept
+{
+    return details::utf::utf8_kernels_for_cpu().validate(s.data(), s.size(), nullptr);
+}
+
+inline std::size_t count_code_points(slice s) noexcept
+{
+    return details::utf::utf8_kernels_for_cpu().count(s.data(), s.size());
+}
+
+inline string validated_utf8_string(slice s)
+{
+    const auto validate = details::utf::utf8_kernels_for_cpu().validate;
+    if (s.size() <= string::inline_capacity) {
+        if (!validate(s.data(), s.size(), nullptr))
+            details::utf::invalid();
+        return string{s.data(), s.size()};
+    }
+
+    string_builder builder{s.size()};
+    builder.append_with(s.size(), [&](char* out, std::size_t count) {
+        if (!validate(s.data(), count, out))
+            details::utf::invalid();
+        return count;
+    });
+    return std::move(builder).str();
+}
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_UTF_IMPL_HPP)
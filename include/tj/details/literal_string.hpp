@@ -14,12 +14,14 @@ namespace tj {
 inline namespace v1 {
 namespace details {
 
-template<std::size_t N>
+template<typename CharT, std::size_t N>
 struct literal_string {
-    char data[N] {};
+    using char_type = CharT;
+
+    CharT data[N] {};
     static constexpr std::size_t size = N - 1;
 
-    constexpr literal_string(const char (&s)[N]) noexcept
+    constexpr literal_string(const CharT (&s)[N]) noexcept
     {
         for (std::size_t i = 0; i < N; ++i)
             data[i] = s[i];
@@ -0,0 +1,49 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_MAPPED_FILE_DETAILS_HPP
+#define TJ_STRING_MAPPED_FILE_DETAILS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_string.hpp>
+
+#include <filesystem>
+
+// Mapping files needs POSIX `mmap`, so `map_file` is only declared where
+// `<sys/mman.h>` exists.
+#if __has_include(<sys/mman.h>)
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+struct file_mapping {
+    static string map(const char* path);
+};
+
+} // namespace details
+
+/// Maps the file at `path` into memory read-only and returns its contents as
+/// a string that refers to the mapping instead of copying it. Throws
+/// `std::system_error` if the file cannot be opened or mapped.
+///
+/// Copies of the string, suffixes made by `share_substr`, and any piece made
+/// by `share_slice` keep the mapping alive through the string's ref-count; it
+/// is unmapped when the last of them is destroyed. Slices made by `substr`
+/// point into the mapping without keeping it alive, like slices of any other
+/// string. The mapping is private, so later changes to the file may or may
+/// not be seen.
+///
+/// Files no longer than `string::inline_capacity` are copied inline. Only
+/// available on POSIX systems.
+string map_file(const std::filesystem::path& path);
+
+} // namespace v1
+} // namespace tj
+
+#endif // __has_include(<sys/mman.h>)
+
+#endif // !defined(TJ_STRING_MAPPED_FILE_DETAILS_HPP)
@@ -0,0 +1,85 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_POOL_ALLOCATOR_HPP
+#define TJ_STRING_POOL_ALLOCATOR_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+/// Per-thread free lists of blocks by power-of-two size class, that
+/// `pool_allocator` takes blocks from before asking the global allocator.
+///
+/// A block goes back to the cache of the thread that frees it, whichever
+/// thread allocated it, so no list is ever shared between threads. Each list
+/// keeps at most `max_cached_bytes` of blocks; the rest are freed.
+class pool_cache {
+public:
+    static constexpr std::size_t min_block = 32;
+    static constexpr std::size_t class_count = 8;
+    static constexpr std::size_t max_block = min_block << (class_count - 1);
+    static constexpr std::size_t max_cached_bytes = 64 * 1024;
+
+    static void* allocate(std::size_t bytes);
+    static void deallocate(void* p, std::size_t bytes) noexcept;
+
+private:
+    struct free_block {
+        free_block* next;
+    };
+
+    struct free_list {
+        free_block* head = nullptr;
+        std::size_t count = 0;
+    };
+
+    std::array<free_list, class_count> lists_;
+
+    pool_cache() = default;
+    ~pool_cache();
+
+    /// Returns the cache of the calling thread, or `nullptr` once it has been
+    /// destroyed at thread exit.
+    static pool_cache* local() noexcept;
+    static std::size_t size_class(std::size_t bytes) noexcept;
+};
+
+} // namespace details
+
+/// A stateless allocator that recycles blocks of up to
+/// `details::pool_cache::max_block` bytes through per-thread free lists, so
+/// strings that are created and destroyed at a high rate rarely reach the
+/// global allocator. Larger blocks are passed through to `operator new`.
+///
+/// Defining `TJ_STRING_POOL_ALLOCATOR` makes it the default allocator of
+/// `tj::basic_string`; it must then be defined in every translation unit.
+template<typename T>
+class pool_allocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    pool_allocator() noexcept = default;
+    template<typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept;
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n) noexcept;
+
+    template<typename U>
+    bool operator==(const pool_allocator<U>& other) const noexcept;
+};
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_POOL_ALLOCATOR_HPP)
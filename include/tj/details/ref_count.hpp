@@ -0,0 +1,43 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_REF_COUNT_HPP
+#define TJ_STRING_REF_COUNT_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <atomic>
+#include <cstddef>
+
+namespace tj {
+inline namespace v1 {
+
+/// Ref-counting policy for strings that may be shared between threads.
+///
+/// Increments are relaxed since a new reference can only be created from an
+/// existing one, and decrements use release/acquire-on-zero so that every
+/// access through other references happens-before the buffer is freed.
+struct atomic_ref_count {
+    using value_type = std::atomic_size_t;
+
+    static void increment(value_type& count) noexcept;
+    /// Returns `true` if the last reference was released.
+    static bool decrement(value_type& count) noexcept;
+};
+
+/// Ref-counting policy for strings that never leave the thread that created
+/// them, e.g. `tj::local_string`.
+struct local_ref_count {
+    using value_type = std::size_t;
+
+    static void increment(value_type& count) noexcept;
+    /// Returns `true` if the last reference was released.
+    static bool decrement(value_type& count) noexcept;
+};
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_REF_COUNT_HPP)
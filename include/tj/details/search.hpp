@@ -0,0 +1,63 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_SEARCH_HPP
+#define TJ_STRING_SEARCH_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace tj {
+inline namespace v1 {
+namespace details {
+
+/// `true` if strings of `CharT` compared with `Traits` can be searched as raw
+/// bytes by the kernels below.
+template<typename CharT, typename Traits>
+inline constexpr bool is_byte_string =
+    sizeof(CharT) == 1 && std::is_same_v<Traits, std::char_traits<CharT>>;
+
+/// A set of bytes with constant-time membership tests.
+class byte_set {
+    std::uint64_t bits_[4] = {};
+
+public:
+    byte_set(const char* first, const char* last) noexcept;
+    bool contains(char c) const noexcept;
+};
+
+// The kernels search `[first, last)` and return `last` if nothing was found.
+// They use AVX2 or SSE2 when the target supports them and fall back to
+// scalar code otherwise.
+namespace simd {
+
+const char* find(const char* first, const char* last, char c) noexcept;
+const char* rfind(const char* first, const char* last, char c) noexcept;
+/// Finds the first occurrence of the non-empty `[s_first, s_last)`.
+const char* find(const char* first, const char* last, const char* s_first,
+                 const char* s_last) noexcept;
+/// Finds the first byte that is any of `[s_first, s_last)`.
+const char* find_first_of(const char* first, const char* last, const char* s_first,
+                          const char* s_last) noexcept;
+
+// The comparison kernels take two ranges of `n` bytes and, like
+// `std::char_traits<char>`, order bytes as `unsigned char`.
+
+/// Returns the index of the first byte that differs, or `n` if none does.
+std::size_t mismatch(const char* lhs, const char* rhs, std::size_t n) noexcept;
+bool equal(const char* lhs, const char* rhs, std::size_t n) noexcept;
+/// Returns a negative value, zero or a positive value like `std::memcmp`.
+int compare(const char* lhs, const char* rhs, std::size_t n) noexcept;
+
+} // namespace simd
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_SEARCH_HPP)
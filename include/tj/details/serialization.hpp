@@ -0,0 +1,51 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_SERIALIZATION_DETAILS_HPP
+#define TJ_STRING_SERIALIZATION_DETAILS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+
+// A serialized collection of strings starts with a 16-byte header: the magic
+// bytes "tjs", a version byte, 4 reserved bytes and the number of entries as
+// a 64-bit integer. An offset table follows, with the 64-bit offset of each
+// entry from the start of the blob. Each entry is a 64-bit length, then the
+// characters and a null-terminator, padded with zeros to a multiple of 8
+// bytes. Integers are little-endian.
+//
+// The null-terminators let deserialized strings share the blob's buffer.
+
+/// Serializes `strings` into a single blob, allocating once.
+template<std::ranges::forward_range R>
+string serialize(const R& strings)
+    requires std::is_convertible_v<std::ranges::range_reference_t<const R>, slice>;
+
+/// Returns slices of the entries of a serialized blob, pointing into `blob`.
+/// Throws `std::invalid_argument` if `blob` is not a valid serialization.
+std::vector<slice> deserialize_slices(slice blob);
+
+/// Returns the entries of a serialized blob as strings that share the buffer
+/// of `blob` rather than allocating their own, e.g. when `blob` comes from
+/// `tj::map_file`. Entries short enough to be stored inline, and entries that
+/// start more than 4 GiB into the blob, are copied. Throws
+/// `std::invalid_argument` if `blob` is not a valid serialization.
+std::vector<string> deserialize(const string& blob);
+
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_SERIALIZATION_DETAILS_HPP)
@@ -0,0 +1,174 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_SORT_DETAILS_HPP
+#define TJ_STRING_SORT_DETAILS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+#include <tj/details/search.hpp>
+
+#include <compare>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+
+// The sorts order strings like `operator<` of `tj::string`, but compare the
+// leading bytes of strings without reading them again. They sort an array of
+// entries, each with the next 8 bytes of its string as a big-endian integer,
+// by multikey quicksort: entries are partitioned on their integer, and only
+// those that are equal read their next 8 bytes. The strings are moved into
+// place at the end, in place along the cycles of the permutation.
+
+/// Sorts the strings in `[first, last)`. It is not stable, but equal strings
+/// are indistinguishable unless they share buffers differently.
+template<std::random_access_iterator It>
+void sort_strings(It first, It last)
+    requires std::is_convertible_v<std::iter_reference_t<It>, slice>;
+
+/// Sorts the strings in `[first, last)` on `threads` threads, or as many as
+/// the hardware runs concurrently if it is 0.
+template<std::random_access_iterator It>
+void parallel_sort_strings(It first, It last, unsigned threads = 0)
+    requires std::is_convertible_v<std::iter_reference_t<It>, slice>;
+
+/// A string together with its first 8 bytes as a big-endian integer, for
+/// keys of ordered containers such as `std::map` and B-trees.
+///
+/// Comparisons compare the integers first, and only read the characters of
+/// both strings if those are equal, so keys that differ in their first 8
+/// bytes are ordered without touching their external buffers. The order is
+/// the same as that of the strings.
+///
+/// With a transparent comparator like `std::less<>`, containers can be
+/// searched with a slice, whose prefix is then loaded on every comparison.
+template<typename CharT, typename Traits = std::char_traits<CharT>,
+         typename Allocator = default_allocator<CharT>, typename RefCount = atomic_ref_count>
+class basic_sort_key {
+    static_assert(details::is_byte_string<CharT, Traits>, "sort keys compare strings as bytes");
+
+public: // Member types
+    using string_type = basic_string<CharT, Traits, Allocator, RefCount>;
+    using slice_type = basic_slice<CharT, Traits>;
+
+private:
+    std::uint64_t prefix_;
+    string_type str_;
+
+public: // Constructors
+    basic_sort_key() noexcept;
+    explicit basic_sort_key(string_type s) noexcept;
+
+public: // Observers
+    const string_type& str() const noexcept;
+    /// Returns the first 8 bytes of the string, big-endian and padded with
+    /// zeros.
+    std::uint64_t prefix() const noexcept;
+
+public: // Comparison
+    friend bool operator==(const basic_sort_key& lhs, const basic_sort_key& rhs) noexcept
+    {
+        return lhs.prefix_ == rhs.prefix_ && lhs.str_.size() == rhs.str_.size()
+               && compare(lhs, rhs.prefix_, rhs.str_) == 0;
+    }
+
+    friend std::strong_ordering operator<=>(const basic_sort_key& lhs, const basic_sort_key& rhs) noexcept
+    {
+        return compare(lhs, rhs.prefix_, rhs.str_) <=> 0;
+    }
+
+    friend bool operator==(const basic_sort_key& lhs, slice_type rhs) noexcept
+    {
+        return slice_type{lhs.str_} == rhs;
+    }
+
+    friend std::strong_ordering operator<=>(const basic_sort_key& lhs, slice_type rhs) noexcept
+    {
+        return compare(lhs, prefix_of(rhs), rhs) <=> 0;
+    }
+
+private:
+    static std::uint64_t prefix_of(slice_type s) noexcept;
+    static int compare(const basic_sort_key& lhs, std::uint64_t rhs_prefix, slice_type rhs) noexcept;
+};
+
+using sort_key = basic_sort_key<char>;
+
+namespace details {
+namespace sort {
+
+struct entry {
+    /// The 8 bytes of the string at the current depth, big-endian and padded
+    /// with zeros.
+    std::uint64_t key;
+    const char* data;
+    std::size_t size;
+    /// The position of the string in the sorted range.
+    std::size_t index;
+};
+
+/// Ranges that are shorter are insertion sorted.
+inline constexpr std::size_t insertion_limit = 16;
+/// Ranges that are longer are sorted by another thread in parallel sorts.
+inline constexpr std::size_t parallel_limit = 1 << 14;
+
+std::uint64_t load_key(const char* data, std::size_t size, std::size_t depth) noexcept;
+/// Compares strings that are equal before `offset`, like `std::memcmp`.
+int compare_from(const char* lhs, std::size_t lhs_size, const char* rhs, std::size_t rhs_size,
+                 std::size_t offset) noexcept;
+/// Compares entries whose strings are equal before `depth`.
+bool less(const entry& lhs, const entry& rhs, std::size_t depth) noexcept;
+
+/// Shares ranges of entries between the threads of a parallel sort, which
+/// finish when every range that was pushed has been sorted.
+class work_queue {
+    struct range {
+        entry* first;
+        entry* last;
+        std::size_t depth;
+        int budget;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<range> ranges_;
+    std::size_t pending_ = 0;
+
+public:
+    /// Returns `false` if there was no memory for the range, which the caller
+    /// must then sort itself.
+    bool push(entry* first, entry* last, std::size_t depth, int budget) noexcept;
+    /// Sorts ranges until all are sorted.
+    void work();
+};
+
+/// Sorts `[first, last)`, whose strings are equal before `depth`. Falls back
+/// to `std::sort` when `budget` partitions did not make the ranges short, and
+/// hands long ranges to `queue` if it is not null.
+void multikey_quicksort(entry* first, entry* last, std::size_t depth, int budget, work_queue* queue);
+
+/// Calls `f(begin, end)` for `threads` consecutive chunks of `[0, n)`, in
+/// parallel. `f` must not throw.
+template<typename F>
+void for_chunks(unsigned threads, std::size_t n, F f) noexcept;
+
+template<std::random_access_iterator It>
+void sort_strings(It first, It last, unsigned threads);
+
+} // namespace sort
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_SORT_DETAILS_HPP)
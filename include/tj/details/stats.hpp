@@ -0,0 +1,105 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_STATS_HPP
+#define TJ_STRING_STATS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace tj {
+inline namespace v1 {
+
+/// Counters of what strings have done in all threads, see `tj::stats()`.
+struct string_stats {
+    /// External buffers allocated and freed, and their size in bytes,
+    /// including headers.
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t freed_bytes = 0;
+    /// Copies that incremented, and releases that decremented, a ref-count.
+    std::uint64_t copies = 0;
+    std::uint64_t releases = 0;
+    /// Strings constructed at run time. Strings constructed from constants
+    /// at compile time cost nothing and are not counted.
+    std::uint64_t literal_constructions = 0;
+    std::uint64_t inline_constructions = 0;
+    std::uint64_t external_constructions = 0;
+    /// Strings constructed as substrings sharing the buffer of another.
+    std::uint64_t shared_constructions = 0;
+    /// Bucket `i` counts the strings constructed with a length in
+    /// `[2^(i-1), 2^i)`; bucket 0 counts empty strings.
+    std::array<std::uint64_t, 32> length_histogram{};
+
+    std::uint64_t live_buffers() const noexcept { return allocations - frees; }
+    std::uint64_t live_bytes() const noexcept { return allocated_bytes - freed_bytes; }
+};
+
+/// Returns the sum of the counters of all threads, including threads that
+/// have exited. The counters are only maintained if `TJ_STRING_STATS` is
+/// defined in every translation unit; otherwise they are all zero.
+string_stats stats();
+
+namespace details {
+
+#if defined(TJ_STRING_STATS)
+inline constexpr bool stats_enabled = true;
+#else
+inline constexpr bool stats_enabled = false;
+#endif
+
+enum stat_counter : std::size_t {
+    stat_allocations,
+    stat_frees,
+    stat_allocated_bytes,
+    stat_freed_bytes,
+    stat_copies,
+    stat_releases,
+    stat_literal_constructions,
+    stat_inline_constructions,
+    stat_external_constructions,
+    stat_shared_constructions,
+    stat_length_histogram,
+    stat_count = stat_length_histogram + std::tuple_size_v<decltype(string_stats::length_histogram)>
+};
+
+/// The counters of one thread. Only the owning thread writes them, so they
+/// are updated with plain relaxed loads and stores rather than atomic
+/// read-modify-writes; `tj::stats()` reads them from other threads.
+class stats_counters {
+public:
+    static void add(stat_counter counter, std::uint64_t n) noexcept;
+    static string_stats snapshot();
+
+private:
+    struct registry;
+
+    std::array<std::atomic<std::uint64_t>, stat_count> values_{};
+    stats_counters* prev_ = nullptr;
+    stats_counters* next_ = nullptr;
+
+    stats_counters() noexcept;
+    ~stats_counters();
+
+    /// Returns the counters of the calling thread, or `nullptr` once they
+    /// have been destroyed at thread exit.
+    static stats_counters* local() noexcept;
+    static registry& global() noexcept;
+};
+
+void count(stat_counter counter, std::uint64_t n = 1) noexcept;
+void count_construction(stat_counter kind, std::size_t len) noexcept;
+
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_STATS_HPP)
@@ -0,0 +1,126 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_UTF_DETAILS_HPP
+#define TJ_STRING_UTF_DETAILS_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/details/basic_slice.hpp>
+#include <tj/details/basic_string.hpp>
+
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+/// Defined if the UTF-8 kernels are chosen at runtime from the features of
+/// the CPU, rather than from the target the library is compiled for.
+#    define TJ_STRING_UTF8_DISPATCH
+#endif
+
+namespace tj {
+inline namespace v1 {
+
+// The conversions take UTF-8 in `char`, UTF-16 in `char16_t` and UTF-32 in
+// `char32_t`, and throw `std::invalid_argument` if the input is not valid in
+// its encoding, e.g. contains unpaired surrogates or overlong UTF-8. They
+// measure the output first, so the result is allocated once, and copy runs of
+// ASCII characters a vector at a time.
+
+u16string to_utf16(slice s);
+u16string to_utf16(u32slice s);
+u32string to_utf32(slice s);
+u32string to_utf32(u16slice s);
+string to_utf8(u16slice s);
+string to_utf8(u32slice s);
+
+/// Returns `true` if `s` is valid UTF-8. Checks 32 or 16 bytes at a time
+/// with AVX2 or SSE4.2 if the CPU supports them.
+bool is_valid_utf8(slice s) noexcept;
+/// Returns the number of code points in the valid UTF-8 `s`, i.e. the number
+/// of bytes that are not continuation bytes.
+std::size_t count_code_points(slice s) noexcept;
+/// Copies `s` into a new string, checking that it is valid UTF-8 in the same
+/// pass. Throws `std::invalid_argument` if it is not.
+string validated_utf8_string(slice s);
+
+namespace details {
+namespace utf {
+
+/// Returns the length of the prefix of `[s, s + n)` of ASCII characters.
+std::size_t ascii_prefix(const char* s, std::size_t n) noexcept;
+std::size_t ascii_prefix(const char16_t* s, std::size_t n) noexcept;
+std::size_t ascii_prefix(const char32_t* s, std::size_t n) noexcept;
+
+/// Copies `n` ASCII characters to `out`, returning the end of the output.
+template<typename To, typename From>
+To* copy_ascii(const From* s, std::size_t n, To* out) noexcept;
+
+/// Decodes the UTF-8 sequence at `s[i]` into `c` and returns its length, or
+/// 0 if it is not valid.
+std::size_t try_decode(const char* s, std::size_t n, std::size_t i, char32_t& c) noexcept;
+
+/// Decodes the code point at `s[i]` and moves `i` past it. Throws
+/// `std::invalid_argument` if it is not a valid code point.
+char32_t decode(const char* s, std::size_t n, std::size_t& i);
+char32_t decode(const char16_t* s, std::size_t n, std::size_t& i);
+char32_t decode(const char32_t* s, std::size_t n, std::size_t& i);
+/// Decodes the multi-byte sequence at `s[i]` of valid UTF-8 without checking
+/// it, and moves `i` past it.
+char32_t decode_validated(const char* s, std::size_t& i) noexcept;
+
+/// Returns the number of code units of `To` that encode `c`.
+template<typename To>
+std::size_t encoded_size(char32_t c) noexcept;
+
+/// Encodes `c` at `out`, returning the end of the output.
+char* encode(char32_t c, char* out) noexcept;
+char16_t* encode(char32_t c, char16_t* out) noexcept;
+char32_t* encode(char32_t c, char32_t* out) noexcept;
+
+/// Returns the number of code units of `To` needed for `[s, s + n)`, after
+/// checking that it is valid. UTF-8 is checked with the vector kernels, so
+/// that `transcode` can decode it without checking again.
+template<typename To, typename From>
+std::size_t transcoded_size(const From* s, std::size_t n);
+
+/// Transcodes the valid `[s, s + n)` to `out`.
+template<typename To, typename From>
+void transcode(const From* s, std::size_t n, To* out);
+
+template<typename To, typename From>
+basic_string<To> transcode(basic_slice<From> s);
+
+/// The UTF-8 kernels for one instruction set.
+struct utf8_kernels {
+    /// Returns `true` if `[s, s + n)` is valid UTF-8. Copies it to `out` as
+    /// well, unless `out` is null.
+    bool (*validate)(const char* s, std::size_t n, char* out) noexcept;
+    std::size_t (*count)(const char* s, std::size_t n) noexcept;
+};
+
+bool validate_scalar(const char* s, std::size_t n, char* out) noexcept;
+std::size_t count_scalar(const char* s, std::size_t n) noexcept;
+inline constexpr utf8_kernels scalar_kernels = {&validate_scalar, &count_scalar};
+
+#if defined(TJ_STRING_UTF8_DISPATCH)
+[[gnu::target("sse4.2,popcnt")]] bool validate_sse4(const char* s, std::size_t n, char* out) noexcept;
+[[gnu::target("sse4.2,popcnt")]] std::size_t count_sse4(const char* s, std::size_t n) noexcept;
+inline constexpr utf8_kernels sse4_kernels = {&validate_sse4, &count_sse4};
+
+[[gnu::target("avx2,popcnt")]] bool validate_avx2(const char* s, std::size_t n, char* out) noexcept;
+[[gnu::target("avx2,popcnt")]] std::size_t count_avx2(const char* s, std::size_t n) noexcept;
+inline constexpr utf8_kernels avx2_kernels = {&validate_avx2, &count_avx2};
+#endif
+
+/// Returns the fastest kernels the CPU supports, checking its features the
+/// first time it is called.
+const utf8_kernels& utf8_kernels_for_cpu() noexcept;
+
+} // namespace utf
+} // namespace details
+} // namespace v1
+} // namespace tj
+
+#endif // !defined(TJ_STRING_UTF_DETAILS_HPP)
@@ -0,0 +1,19 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_FLAT_MAP_HPP
+#define TJ_STRING_FLAT_MAP_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/string.hpp>
+
+#include <tj/details/flat_table.hpp>
+#include <tj/details/flat_map.hpp>
+
+#include <tj/details/impl/flat_table.hpp>
+#include <tj/details/impl/flat_map.hpp>
+
+#endif // !defined(TJ_STRING_FLAT_MAP_HPP)
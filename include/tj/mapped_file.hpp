@@ -0,0 +1,17 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#ifndef TJ_STRING_MAPPED_FILE_HPP
+#define TJ_STRING_MAPPED_FILE_HPP
+
+#ifndef __cplusplus
+#    error "This file is only meant for C++ compilers"
+#endif // defined(__cplusplus)
+
+#include <tj/string.hpp>
+
+#include <tj/details/mapped_file.hpp>
+
+#include <tj/details/impl/mapped_file.hpp>
+
+#endif // !defined(TJ_STRING_MAPPED_FILE_HPP)
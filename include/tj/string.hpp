@@ -8,6 +8,8 @@
 #    error "This file is only meant for C++ compilers"
 #endif // defined(__cplusplus)
 
+#include <memory>
+#include <memory_resource>
 #include <string>
 
 namespace tj {
@@ -16,19 +18,68 @@ inline namespace v1 {
 template<typename CharT, typename Traits = std::char_traits<CharT>>
 class basic_slice;
 
-template<typename CharT, typename Traits = std::char_traits<CharT>>
+struct atomic_ref_count;
+struct local_ref_count;
+
+template<typename T>
+class pool_allocator;
+
+/// The allocator of strings that do not name one; see `pool_allocator`.
+#if defined(TJ_STRING_POOL_ALLOCATOR)
+template<typename T>
+using default_allocator = pool_allocator<T>;
+#else
+template<typename T>
+using default_allocator = std::allocator<T>;
+#endif
+
+template<typename CharT, typename Traits = std::char_traits<CharT>,
+         typename Allocator = default_allocator<CharT>, typename RefCount = atomic_ref_count>
 class basic_string;
 
 template<typename CharT, typename Traits = std::char_traits<CharT>>
 class basic_string_view;
 
+template<typename CharT, typename Traits = std::char_traits<CharT>,
+         typename Allocator = default_allocator<CharT>, typename RefCount = atomic_ref_count>
+class basic_string_builder;
+
+template<typename CharT, typename Traits = std::char_traits<CharT>,
+         typename Allocator = default_allocator<CharT>, typename RefCount = atomic_ref_count>
+class basic_shared_slice;
+
 using slice = basic_slice<char>;
 using string = basic_string<char>;
 using string_view = basic_string_view<char>;
+using string_builder = basic_string_builder<char>;
+using shared_slice = basic_shared_slice<char>;
+
+/// A string whose ref-count is not atomic; copies must stay on one thread.
+using local_string = basic_string<char, std::char_traits<char>, default_allocator<char>, local_ref_count>;
 
 using wslice = basic_slice<wchar_t>;
 using wstring = basic_string<wchar_t>;
 using wstring_view = basic_string<wchar_t>;
+using wstring_builder = basic_string_builder<wchar_t>;
+using wshared_slice = basic_shared_slice<wchar_t>;
+using wlocal_string =
+    basic_string<wchar_t, std::char_traits<wchar_t>, default_allocator<wchar_t>, local_ref_count>;
+
+using u16slice = basic_slice<char16_t>;
+using u16string = basic_string<char16_t>;
+using u32slice = basic_slice<char32_t>;
+using u32string = basic_string<char32_t>;
+
+namespace pmr {
+
+/// Strings whose external buffers are allocated from a `std::pmr::memory_resource`.
+template<typename CharT, typename Traits = std::char_traits<CharT>>
+using basic_string = tj::basic_string<CharT, Traits, std::pmr::polymorphic_allocator<CharT>>;
+
+using string = basic_string<char>;
+using wstring = basic_string<wchar_t>;
+
+} // namespace pmr
 
 namespace details {
 
@@ -41,15 +92,29 @@ class basic_string_range;
 } // namespace tj
 
 
+#include <tj/details/ref_count.hpp>
+#include <tj/details/pool_allocator.hpp>
+#include <tj/details/stats.hpp>
+#include <tj/details/hash.hpp>
+#include <tj/details/search.hpp>
 #include <tj/details/basic_string_range.hpp>
 #include <tj/details/basic_slice.hpp>
 #include <tj/details/basic_string.hpp>
 #include <tj/details/basic_string_view.hpp>
-
+#include <tj/details/basic_string_builder.hpp>
+#include <tj/details/basic_shared_slice.hpp>
+
+#include <tj/details/impl/ref_count.hpp>
+#include <tj/details/impl/pool_allocator.hpp>
+#include <tj/details/impl/stats.hpp>
+#include <tj/details/impl/hash.hpp>
+#include <tj/details/impl/search.hpp>
 #include <tj/details/impl/basic_string_range.hpp>
 #include <tj/details/impl/basic_slice.hpp>
 #include <tj/details/impl/basic_string.hpp>
 #include <tj/details/impl/basic_string_view.hpp>
+#include <tj/details/impl/basic_string_builder.hpp>
+#include <tj/details/impl/basic_shared_slice.hpp>
 
 #include <tj/details/impl/basic_string_io.hpp>
 
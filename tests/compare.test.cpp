@@ -0,0 +1,83 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+int sign(int order)
+{
+    return (order > 0) - (order < 0);
+}
+
+} // namespace
+
+TEST_CASE("compare" * doctest::description("tj::slice::compare behaves like std::string_view::compare")
+          * doctest::test_suite("compare"))
+{
+    // Covers the vectorized loops, their scalar tails, long ranges and bytes
+    // above 0x7f, which must order as unsigned char.
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = 0; n <= 140; ++n)
+        sizes.push_back(n);
+    sizes.push_back(255);
+    sizes.push_back(256);
+    sizes.push_back(300);
+    for (const auto n : sizes) {
+        const std::string lhs(n, 'a');
+        for (std::size_t i = 0; i < n; ++i) {
+            for (const char c : {'\x01', 'b', '\xff'}) {
+                auto rhs = lhs;
+                rhs[i] = c;
+                CAPTURE(n);
+                CAPTURE(i);
+                CHECK(sign(slice{lhs}.compare(rhs)) == sign(std::string_view{lhs}.compare(rhs)));
+                CHECK(sign(slice{rhs}.compare(lhs)) == sign(std::string_view{rhs}.compare(lhs)));
+                CHECK(!slice{lhs}.equals(rhs));
+                CHECK(slice{lhs} != slice{rhs});
+            }
+        }
+        CHECK(slice{lhs}.compare(std::string(n, 'a')) == 0);
+        CHECK(slice{lhs}.equals(std::string(n, 'a')));
+        CHECK(slice{lhs}.compare(lhs + "a") < 0);
+        CHECK(!slice{lhs}.equals(lhs + "a"));
+    }
+}
+
+TEST_CASE("equality of shared characters"
+          * doctest::description("copies of a tj::string compare equal by identity")
+          * doctest::test_suite("compare"))
+{
+    const std::string text(100, 'x');
+    const string s1{text.data(), text.size()};
+    const string s2{s1};
+    CHECK(s1.equals(s2));
+    CHECK(s1 == s2);
+    CHECK(s1.compare(s2) == 0);
+    CHECK(!s1.equals(slice{s1.data(), 99}));
+}
+
+TEST_CASE("compare at compile time"
+          * doctest::description("tj::slice comparisons are constant expressions")
+          * doctest::test_suite("compare"))
+{
+    static_assert(slice{"hello"}.equals("hello"));
+    static_assert(!slice{"hello"}.equals("hellp"));
+    static_assert(slice{"hello"}.compare("hellp") < 0);
+    static_assert(slice{"hello"} < slice{"hello, world"});
+    CHECK(wslice{L"abc"}.equals(L"abc"));
+    CHECK(wslice{L"abc"}.compare(L"abd") < 0);
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
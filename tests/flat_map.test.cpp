@@ -0,0 +1,179 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/flat_map.hpp>
+#include <tj/flat_set.hpp>
+
+#include <doctest.h>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+string make_key(int i)
+{
+    const auto s = "a key too long to be inline #" + std::to_string(i);
+    return string{s.data(), s.size()};
+}
+
+} // namespace
+
+TEST_CASE("insert and find" * doctest::description("tj::flat_map finds what was inserted")
+          * doctest::test_suite("flat_map"))
+{
+    flat_map<string, int> map;
+    CHECK(map.empty());
+    CHECK(map.find(slice{"missing"}) == map.end());
+
+    for (int i = 0; i != 1000; ++i)
+        CHECK(map.try_emplace(make_key(i), i).second);
+    CHECK(map.size() == 1000);
+    CHECK(map.capacity() * 7 / 8 >= map.size());
+
+    for (int i = 0; i != 1000; ++i) {
+        const auto it = map.find(make_key(i));
+        REQUIRE(it != map.end());
+        CHECK(it->second == i);
+    }
+    CHECK(!map.try_emplace(make_key(7), -1).second);
+    CHECK(map.at(make_key(7)) == 7);
+    CHECK_THROWS_AS(map.at(slice{"missing"}), std::out_of_range);
+
+    std::size_t count = 0;
+    for (const auto& [key, value] : map) {
+        CHECK(key == make_key(value));
+        ++count;
+    }
+    CHECK(count == map.size());
+}
+
+TEST_CASE("heterogeneous lookup"
+          * doctest::description("tj::flat_map is probed with slices without creating keys")
+          * doctest::test_suite("flat_map"))
+{
+    using namespace std::literals;
+    flat_map<string, int> map{{string{"content-type"}, 1}, {string{"accept"}, 2}};
+    CHECK(map.contains(slice{"accept"}));
+    CHECK(map.contains("content-type"sv));
+    CHECK(map.count("content-type"s) == 1);
+    CHECK(map.at(string_view{"accept"}) == 2);
+    CHECK(!map.contains("host"));
+    CHECK(map.erase(slice{"accept"}) == 1);
+    CHECK(!map.contains("accept"));
+}
+
+TEST_CASE("operator[] and insert_or_assign"
+          * doctest::description("tj::flat_map inserts default values and assigns")
+          * doctest::test_suite("flat_map"))
+{
+    flat_map<string, int> map;
+    ++map[string{"a"}];
+    ++map[string{"a"}];
+    CHECK(map.at("a") == 2);
+    CHECK(!map.insert_or_assign(string{"a"}, 5).second);
+    CHECK(map.insert_or_assign(string{"b"}, 6).second);
+    CHECK(map.at("a") == 5);
+    CHECK(map.at("b") == 6);
+}
+
+TEST_CASE("erase" * doctest::description("tj::flat_map reuses erased slots")
+          * doctest::test_suite("flat_map"))
+{
+    flat_map<string, int> map;
+    std::map<std::string, int> expected;
+    for (int round = 0; round != 20; ++round) {
+        for (int i = 0; i != 200; ++i) {
+            const auto key = make_key(round * 100 + i);
+            map.insert_or_assign(key, i);
+            expected[std::string{key.data(), key.size()}] = i;
+        }
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->second % 3 == 0) {
+                expected.erase(std::string{it->first.data(), it->first.size()});
+                it = map.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    CHECK(map.size() == expected.size());
+    CHECK(map.capacity() <= 4096); // Tombstones must not grow the table forever.
+    for (const auto& [key, value] : expected)
+        CHECK(map.at(key) == value);
+}
+
+TEST_CASE("throwing insert"
+          * doctest::description("tj::flat_map gives the slot back when a value fails to construct")
+          * doctest::test_suite("flat_map"))
+{
+    struct throwing {
+        explicit throwing(bool fail)
+        {
+            if (fail)
+                throw std::runtime_error{"construction failed"};
+        }
+    };
+
+    // Fill the table so that erasing leaves tombstones in full groups, which
+    // failed inserts must not turn back into empty slots.
+    flat_map<string, throwing> map;
+    map.reserve(1000);
+    const auto n = static_cast<int>(map.capacity() * 7 / 8);
+    for (int i = 0; i != n; ++i)
+        map.try_emplace(make_key(i), false);
+    for (int i = 0; i < n; i += 3)
+        map.erase(make_key(i));
+    for (int i = 0; i < n; i += 3)
+        CHECK_THROWS_AS(map.try_emplace(make_key(i), true), std::runtime_error);
+
+    CHECK(map.size() == static_cast<std::size_t>(n - (n + 2) / 3));
+    for (int i = 0; i != n; ++i)
+        CHECK(map.contains(make_key(i)) == (i % 3 != 0));
+}
+
+TEST_CASE("copy and move" * doctest::description("tj::flat_map can be copied and moved")
+          * doctest::test_suite("flat_map"))
+{
+    flat_map<string, int> map;
+    for (int i = 0; i != 100; ++i)
+        map.try_emplace(make_key(i), i);
+
+    const auto copy = map;
+    CHECK(copy.size() == 100);
+    CHECK(copy.at(make_key(42)) == 42);
+    // Copied keys share their buffers.
+    CHECK(copy.find(make_key(42))->first.data() == map.find(make_key(42))->first.data());
+
+    const auto moved = std::move(map);
+    CHECK(moved.size() == 100);
+    CHECK(map.empty());
+    CHECK(map.find(make_key(1)) == map.end());
+    map.clear();
+}
+
+TEST_CASE("set" * doctest::description("tj::flat_set stores unique strings")
+          * doctest::test_suite("flat_map"))
+{
+    flat_set<string> set{string{"a"}, string{"b"}, string{"a"}};
+    CHECK(set.size() == 2);
+    CHECK(set.contains("a"));
+    CHECK(!set.insert(string{"b"}).second);
+    CHECK(set.emplace("a string too long to be stored inline").second);
+    CHECK(set.contains(slice{"a string too long to be stored inline"}));
+    CHECK(set.erase(set.find("a")) != set.begin());
+    CHECK(set.size() == 2);
+
+    flat_set<std::string> std_set;
+    std_set.insert("std::string keys work too");
+    CHECK(std_set.contains(slice{"std::string keys work too"}));
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
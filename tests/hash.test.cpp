@@ -0,0 +1,69 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+TEST_CASE("equal contents hash equally"
+          * doctest::description("tj::string, tj::string_view and tj::slice hash alike")
+          * doctest::test_suite("hash"))
+{
+    const std::string s{"content-type: application/json"};
+    const string s1{s.data(), s.size()};
+    const string s2{"content-type: application/json"};
+    const string_view sv{s1};
+    const slice ss{s};
+
+    CHECK(std::hash<string>{}(s1) == std::hash<string>{}(s2));
+    CHECK(std::hash<string>{}(s1) == std::hash<string_view>{}(sv));
+    CHECK(std::hash<string>{}(s1) == std::hash<slice>{}(ss));
+    CHECK(hash{}(s1) == hash{}(s.c_str()));
+    CHECK(s1.hash() == s1.hash()); // Repeated hashing must return the memoized value
+
+    const char* get = "GET";
+    const string inline_string{get};
+    CHECK(inline_string.hash() == slice{"GET"}.hash());
+    CHECK(inline_string.hash() != slice{"PUT"}.hash());
+    CHECK(slice{"GET"}.hash() != slice{"GET "}.hash());
+}
+
+TEST_CASE("literal hashes are computed at compile time"
+          * doctest::description("hashing a user-defined literal is a constant expression")
+          * doctest::test_suite("hash"))
+{
+    using namespace tj::literals;
+    constexpr auto h = "content-type"_is.hash();
+    static_assert(h == hash{}(slice{"content-type"}));
+    CHECK(h == string{"content-type", 12}.hash());
+}
+
+TEST_CASE("heterogeneous lookup"
+          * doctest::description("containers keyed by tj::string can be probed with tj::slice")
+          * doctest::test_suite("hash"))
+{
+    std::unordered_map<string, int, hash, std::equal_to<>> map;
+    map.emplace(string{"content-type: application/json"}, 1);
+    map.emplace(string{"accept"}, 2);
+
+    const std::string key{"content-type: application/json"};
+    const auto it = map.find(slice{key});
+    REQUIRE(it != map.end());
+    CHECK(it->second == 1);
+    CHECK(map.contains(slice{"accept"}));
+    CHECK(!map.contains(slice{"accept-encoding"}));
+
+    std::unordered_set<string> set{string{"a"}, string{"b"}};
+    CHECK(set.contains(string{"a"}));
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
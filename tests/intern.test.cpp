@@ -0,0 +1,67 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/intern.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+TEST_CASE("interned strings share buffers"
+          * doctest::description("equal interned strings point at the same characters")
+          * doctest::test_suite("intern"))
+{
+    const std::string s1{"content-type: application/json"};
+    const std::string s2{s1};
+    const string i1 = intern(s1);
+    const string i2 = intern(s2);
+    CHECK(i1 == s1);
+    CHECK(i1.data() == i2.data()); // Equal strings must share one buffer,
+    CHECK(i1.data() != s1.data()); // which must not be the caller's.
+
+    const string i3 = intern("content-length: 42");
+    CHECK(i3.data() != i1.data());
+}
+
+TEST_CASE("short interned strings"
+          * doctest::description("short interned strings are stored inline")
+          * doctest::test_suite("intern"))
+{
+    intern_table table;
+    const string i1 = table.intern("GET");
+    const string i2 = table.intern("GET");
+    CHECK(i1 == "GET");
+    CHECK(i1 == i2);
+    CHECK(table.size() == 0);
+}
+
+TEST_CASE("concurrent interning"
+          * doctest::description("threads interning equal strings get the same buffer")
+          * doctest::test_suite("intern"))
+{
+    intern_table table;
+    std::vector<string> results(8);
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+        threads.emplace_back([&table, &result] {
+            for (int i = 0; i < 100; ++i)
+                table.intern("x-correlation-id-" + std::to_string(i));
+            result = table.intern("x-correlation-id-42");
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(table.size() == 100);
+    for (const auto& result : results)
+        CHECK(result.data() == results.front().data());
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,93 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/mapped_file.hpp>
+
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#if __has_include(<sys/mman.h>)
+
+#    include <unistd.h>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+struct temp_file {
+    std::filesystem::path path;
+
+    explicit temp_file(const std::string& contents)
+      : path{std::filesystem::temp_directory_path()
+             / ("tj_string_mapped_file_" + std::to_string(::getpid()))}
+    {
+        std::ofstream{path, std::ios::binary}.write(contents.data(), contents.size());
+    }
+
+    ~temp_file() { std::filesystem::remove(path); }
+};
+
+} // namespace
+
+TEST_CASE("map file" * doctest::description("tj::map_file refers to the mapped file without copying it")
+          * doctest::test_suite("mapped_file"))
+{
+    std::string contents;
+    for (int i = 0; i != 1000; ++i)
+        contents += "entry " + std::to_string(i) + '\n';
+    const temp_file file{contents};
+
+    string suffix;
+    shared_slice line;
+    {
+        const auto s = map_file(file.path);
+        CHECK(s.size() == contents.size());
+        CHECK(s == std::string_view{contents});
+        CHECK(s.c_str()[s.size()] == '\0');
+
+        const string copy{s};
+        CHECK(copy.data() == s.data());
+        CHECK(copy.hash() == s.hash());
+
+        const auto entry = s.substr(6, 1);
+        CHECK(entry.data() == s.data() + 6);
+        CHECK(entry == "0");
+
+        suffix = s.share_substr(contents.size() - 40);
+        CHECK(suffix.data() == s.data() + contents.size() - 40);
+        line = s.share_slice(8, 7);
+        CHECK(line.data() == s.data() + 8);
+    }
+    // The suffix and the line keep the mapping alive.
+    CHECK(suffix == "entry 996\nentry 997\nentry 998\nentry 999\n");
+    CHECK(line == "entry 1");
+}
+
+TEST_CASE("map file sizes" * doctest::description("tj::map_file null-terminates files of any size")
+          * doctest::test_suite("mapped_file"))
+{
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    for (const auto size : {std::size_t{1}, string::inline_capacity + 1, page - 1, page, 2 * page}) {
+        const temp_file file{std::string(size, 'x')};
+        const auto s = map_file(file.path);
+        CHECK(s.size() == size);
+        CHECK(s.c_str()[size] == '\0');
+        CHECK(s.data()[size - 1] == 'x');
+    }
+
+    const temp_file empty{""};
+    CHECK(map_file(empty.path).empty());
+
+    CHECK_THROWS_AS(map_file(empty.path / "missing"), std::system_error);
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
+
+#endif // __has_include(<sys/mman.h>)
@@ -0,0 +1,83 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <thread>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+using pool_string = basic_string<char, std::char_traits<char>, pool_allocator<char>>;
+
+} // namespace
+
+TEST_CASE("pool allocator reuse"
+          * doctest::description("tj::pool_allocator recycles freed blocks of the same size class")
+          * doctest::test_suite("pool_allocator"))
+{
+    pool_allocator<char> alloc;
+    const auto p1 = alloc.allocate(100);
+    alloc.deallocate(p1, 100);
+    const auto p2 = alloc.allocate(120); // 100 and 120 bytes share the 128-byte class,
+    CHECK(p2 == p1);
+    const auto p3 = alloc.allocate(120);
+    CHECK(p3 != p2); // but a block is only handed out once.
+    alloc.deallocate(p3, 120);
+    alloc.deallocate(p2, 120);
+
+    const auto big = details::pool_cache::max_block + 1;
+    const auto p4 = alloc.allocate(big); // Larger blocks are not pooled.
+    alloc.deallocate(p4, big);
+
+    CHECK(pool_allocator<int>{} == pool_allocator<char>{});
+}
+
+TEST_CASE("pool allocator strings"
+          * doctest::description("strings using tj::pool_allocator reuse freed buffers")
+          * doctest::test_suite("pool_allocator"))
+{
+    const char* text = "a string too long to be stored inline";
+    const void* data;
+    {
+        const pool_string s1{text};
+        data = s1.data();
+        const pool_string s2{s1};
+        CHECK(s2.data() == s1.data());
+    }
+    const pool_string s3{text};
+    CHECK(static_cast<const void*>(s3.data()) == data);
+    CHECK(s3 == text);
+}
+
+TEST_CASE("pool allocator threads"
+          * doctest::description("blocks freed on another thread join that thread's cache")
+          * doctest::test_suite("pool_allocator"))
+{
+    pool_allocator<char> alloc;
+    const auto p = alloc.allocate(1000);
+    char* reused = nullptr;
+    std::thread{[&] {
+        alloc.deallocate(p, 1000);
+        reused = alloc.allocate(1000);
+        alloc.deallocate(reused, 1000);
+    }}.join();
+    CHECK(reused == p);
+
+    // Strings destroyed at thread exit after the thread's cache must not use it.
+    std::thread{[] {
+        thread_local pool_string late; // Constructed before the cache, so destroyed after it.
+        const char* text = "a string too long to be stored inline";
+        late = pool_string{text};
+        CHECK(late.size() > pool_string::inline_capacity);
+    }}.join();
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
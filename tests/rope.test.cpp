@@ -0,0 +1,208 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/rope.hpp>
+
+#include <doctest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+string make_piece(int i)
+{
+    const auto s = "a piece too long to be merged, number " + std::to_string(i) + std::string(256, '.');
+    return string{s.data(), s.size()};
+}
+
+std::string to_std(const rope& r)
+{
+    std::string result;
+    for (const auto chunk : r.chunks())
+        result.append(chunk.data(), chunk.size());
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("rope construction" * doctest::description("tj::rope shares the buffer of its string")
+          * doctest::test_suite("rope"))
+{
+    const rope empty;
+    CHECK(empty.empty());
+    CHECK(empty.size() == 0);
+    CHECK(empty.chunks().begin() == empty.chunks().end());
+    CHECK(empty.flatten().empty());
+
+    const auto s = make_piece(0);
+    const rope r{s};
+    CHECK(r.size() == s.size());
+    CHECK(r.height() == 0);
+    CHECK((*r.chunks().begin()).data() == s.data()); // Leaves refer to the string,
+    CHECK(r.flatten().data() == s.data());            // and a whole leaf is not copied.
+
+    const rope copy{slice{"hello"}};
+    CHECK(copy.flatten() == "hello");
+    CHECK(copy.at(1) == 'e');
+    CHECK_THROWS_AS(copy.at(5), std::out_of_range);
+}
+
+TEST_CASE("rope concatenation"
+          * doctest::description("tj::rope concatenates without copying long leaves and stays balanced")
+          * doctest::test_suite("rope"))
+{
+    rope r;
+    std::string expected;
+    std::vector<string> pieces;
+    for (int i = 0; i != 1000; ++i) {
+        pieces.push_back(make_piece(i));
+        r += pieces.back();
+        expected.append(pieces.back().data(), pieces.back().size());
+    }
+    CHECK(r.size() == expected.size());
+    CHECK(r.height() <= 15); // 1.44 * log2(1000)
+    CHECK(to_std(r) == expected);
+
+    int i = 0;
+    for (const auto chunk : r.chunks())
+        CHECK(chunk.data() == pieces[i++].data());
+    CHECK(i == 1000);
+
+    for (std::size_t pos = 0; pos < expected.size(); pos += 997)
+        CHECK(r[pos] == expected[pos]);
+
+    // Prepending and joining unequal trees keeps the rope balanced as well.
+    rope prepended;
+    for (int j = 0; j != 1000; ++j)
+        prepended = rope{pieces[j]} + prepended;
+    CHECK(prepended.height() <= 15);
+    const auto joined = prepended + rope{pieces[0]} + r;
+    CHECK(joined.height() <= 16);
+    CHECK(joined.size() == prepended.size() + pieces[0].size() + r.size());
+    CHECK(to_std(joined).substr(prepended.size() + pieces[0].size()) == expected);
+}
+
+TEST_CASE("rope small leaves"
+          * doctest::description("tj::rope merges short leaves when concatenating")
+          * doctest::test_suite("rope"))
+{
+    rope r;
+    std::string expected;
+    for (int i = 0; i != 1000; ++i) {
+        const auto s = std::to_string(i);
+        r += rope{slice{s.data(), s.size()}};
+        expected += s;
+    }
+    CHECK(to_std(r) == expected);
+
+    std::size_t chunks = 0;
+    for (const auto chunk : r.chunks()) {
+        CHECK(chunk.size() <= rope::leaf_merge_limit);
+        ++chunks;
+    }
+    CHECK(chunks < expected.size() / (rope::leaf_merge_limit / 4));
+}
+
+TEST_CASE("rope character appends"
+          * doctest::description("tj::rope fills leaves when pieces are added one at a time")
+          * doctest::test_suite("rope"))
+{
+    const auto count_leaves = [](const rope& r) {
+        std::size_t leaves = 0;
+        for (const auto chunk : r.chunks()) {
+            CHECK(chunk.size() <= rope::leaf_merge_limit);
+            ++leaves;
+        }
+        return leaves;
+    };
+
+    constexpr std::size_t n = 20000;
+    const std::size_t full_leaves = (n + rope::leaf_merge_limit - 1) / rope::leaf_merge_limit;
+    rope appended;
+    rope prepended;
+    std::string expected;
+    for (std::size_t i = 0; i != n; ++i) {
+        const char c = static_cast<char>('a' + i % 26);
+        appended += rope{slice{&c, 1}};
+        prepended = rope{slice{&c, 1}} + prepended;
+        expected += c;
+    }
+    CHECK(to_std(appended) == expected);
+    CHECK(to_std(prepended) == std::string(expected.rbegin(), expected.rend()));
+    CHECK(count_leaves(appended) == full_leaves);
+    CHECK(count_leaves(prepended) == full_leaves);
+    CHECK(appended.height() <= 10); // 1.44 * log2(79)
+    CHECK(prepended.height() <= 10);
+}
+
+TEST_CASE("rope substring" * doctest::description("tj::rope::substr shares the leaves of the rope")
+          * doctest::test_suite("rope"))
+{
+    rope r;
+    std::string expected;
+    for (int i = 0; i != 100; ++i) {
+        const auto piece = make_piece(i);
+        r += piece;
+        expected.append(piece.data(), piece.size());
+    }
+
+    for (std::size_t pos = 0; pos < expected.size(); pos += 1013) {
+        for (std::size_t count : {std::size_t{0}, std::size_t{1}, std::size_t{300}, std::size_t{5000}}) {
+            const auto sub = r.substr(pos, count);
+            CHECK(to_std(sub) == expected.substr(pos, count));
+            CHECK(sub.height() <= r.height() + 1);
+        }
+    }
+
+    const auto whole = r.substr();
+    CHECK((*whole.chunks().begin()).data() == (*r.chunks().begin()).data());
+    const auto inner = r.substr(10, 20);
+    CHECK((*inner.chunks().begin()).data() == (*r.chunks().begin()).data() + 10);
+
+    CHECK(r.substr(r.size()).empty());
+    CHECK_THROWS_AS(r.substr(r.size() + 1), std::out_of_range);
+}
+
+TEST_CASE("rope flatten" * doctest::description("tj::rope::flatten copies the characters once")
+          * doctest::test_suite("rope"))
+{
+    const auto a = make_piece(1);
+    const auto b = make_piece(2);
+    const auto r = rope{a} + rope{b};
+    const auto flat = r.flatten();
+    CHECK(flat.size() == a.size() + b.size());
+    CHECK(std::string{flat.data(), flat.size()} == to_std(r));
+    CHECK(flat.c_str()[flat.size()] == '\0');
+
+    const auto short_rope = r.substr(3, 5);
+    CHECK(short_rope.flatten() == "iece ");
+
+    std::ostringstream os;
+    os << r;
+    CHECK(os.str() == to_std(r));
+}
+
+TEST_CASE("rope lifetime" * doctest::description("tj::rope keeps its leaves alive")
+          * doctest::test_suite("rope"))
+{
+    rope r;
+    {
+        const auto s = make_piece(3);
+        const rope a{s};
+        r = a + a;
+    }
+    const auto sub = r.substr(1, r.size() - 2);
+    r = rope{};
+    CHECK(to_std(sub).starts_with(" piece too long"));
+    CHECK(wrope{wslice{L"wide"}}.flatten() == L"wide");
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,116 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+// Long enough to exercise the vectorized loops as well as their scalar tails.
+const std::string haystack = "GET /index.html HTTP/1.1\r\nHost: example.com\r\n"
+                             "Accept: text/html, application/xhtml+xml;q=0.9\r\n"
+                             "Content-Type: text/plain; charset=utf-8\r\n\r\n";
+
+const std::vector<std::string> needles = {
+    "", "G", "\n", "\r\n", "\r\n\r\n", "Host", "html", "text/", "charset=utf-8", "xyz",
+    "GET /index.html HTTP/1.1", "utf-8\r\n\r\n", ", ;=", haystack, haystack + "!"};
+
+} // namespace
+
+TEST_CASE("find" * doctest::description("tj::slice::find behaves like std::string_view::find")
+          * doctest::test_suite("search"))
+{
+    const slice s{haystack};
+    const std::string_view sv{haystack};
+    for (const auto& needle : needles) {
+        for (std::size_t pos = 0; pos <= haystack.size() + 1; ++pos) {
+            CAPTURE(needle);
+            CAPTURE(pos);
+            CHECK(s.find(needle, pos) == sv.find(needle, pos));
+            CHECK(s.rfind(needle, pos) == sv.rfind(needle, pos));
+            CHECK(s.find_first_of(needle, pos) == sv.find_first_of(needle, pos));
+            CHECK(s.find_last_of(needle, pos) == sv.find_last_of(needle, pos));
+            CHECK(s.find_first_not_of(needle, pos) == sv.find_first_not_of(needle, pos));
+            CHECK(s.find_last_not_of(needle, pos) == sv.find_last_not_of(needle, pos));
+        }
+    }
+}
+
+TEST_CASE("find character"
+          * doctest::description("tj::slice::find(char) behaves like std::string_view::find")
+          * doctest::test_suite("search"))
+{
+    const slice s{haystack};
+    const std::string_view sv{haystack};
+    for (const char c : std::string{"G\r\n:;=x\x7f"}) {
+        for (std::size_t pos = 0; pos <= haystack.size() + 1; ++pos) {
+            CAPTURE(c);
+            CAPTURE(pos);
+            CHECK(s.find(c, pos) == sv.find(c, pos));
+            CHECK(s.rfind(c, pos) == sv.rfind(c, pos));
+            CHECK(s.find_first_of(c, pos) == sv.find_first_of(c, pos));
+            CHECK(s.find_last_of(c, pos) == sv.find_last_of(c, pos));
+            CHECK(s.find_first_not_of(c, pos) == sv.find_first_not_of(c, pos));
+            CHECK(s.find_last_not_of(c, pos) == sv.find_last_not_of(c, pos));
+        }
+    }
+    CHECK(slice{}.find('a') == slice::npos);
+    CHECK(slice{}.rfind('a') == slice::npos);
+}
+
+TEST_CASE("find in wide strings"
+          * doctest::description("search works for strings that are not searched as bytes")
+          * doctest::test_suite("search"))
+{
+    const wstring s{L"key=value; other=thing", 22};
+    CHECK(s.find(L"other") == 11);
+    CHECK(s.find(L'=') == 3);
+    CHECK(s.rfind(L'=') == 16);
+    CHECK(s.find_first_of(L";=") == 3);
+    CHECK(s.find_last_not_of(L"thing") == 16);
+}
+
+TEST_CASE("search at compile time"
+          * doctest::description("search functions are usable in constant expressions")
+          * doctest::test_suite("search"))
+{
+    constexpr slice s{"key=value; other=thing"};
+    static_assert(s.find("other") == 11);
+    static_assert(s.find('=') == 3);
+    static_assert(s.rfind('=') == 16);
+    static_assert(s.find_first_of(";=") == 3);
+    static_assert(s.starts_with("key"));
+    static_assert(s.ends_with('g'));
+    static_assert(s.contains("value"));
+}
+
+TEST_CASE("starts_with, ends_with and contains"
+          * doctest::description("tj::string supports prefix, suffix and substring tests")
+          * doctest::test_suite("search"))
+{
+    const string s{"content-type: application/json"};
+    CHECK(s.starts_with("content-"));
+    CHECK(s.starts_with('c'));
+    CHECK(!s.starts_with("content-length"));
+    CHECK(s.ends_with("/json"));
+    CHECK(s.ends_with('n'));
+    CHECK(!s.ends_with("/xml"));
+    CHECK(s.contains("application"));
+    CHECK(s.contains(':'));
+    CHECK(!s.contains('!'));
+    CHECK(s.starts_with(""));
+    CHECK(string{}.ends_with(""));
+    CHECK(!string{}.ends_with('x'));
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,87 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/serialization.hpp>
+
+#include <doctest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+TEST_CASE("serialization round trip"
+          * doctest::description("tj::deserialize returns the strings given to tj::serialize")
+          * doctest::test_suite("serialization"))
+{
+    std::vector<std::string> entries{"", "a", "hello, world", std::string(1000, 'x')};
+    for (int i = 0; i != 100; ++i)
+        entries.push_back("an entry too long to be stored inline #" + std::to_string(i));
+
+    std::vector<string> strings;
+    for (const auto& entry : entries)
+        strings.emplace_back(entry.data(), entry.size());
+
+    const auto blob = serialize(strings);
+    CHECK(blob.size() % 8 == 0);
+
+    const auto slices = deserialize_slices(blob);
+    REQUIRE(slices.size() == entries.size());
+    for (std::size_t i = 0; i != entries.size(); ++i) {
+        CHECK(slices[i] == entries[i]);
+        CHECK(slices[i].data() >= blob.data()); // Slices point into the blob.
+        CHECK(slices[i].data() < blob.data() + blob.size());
+    }
+
+    const auto deserialized = deserialize(blob);
+    REQUIRE(deserialized.size() == entries.size());
+    for (std::size_t i = 0; i != entries.size(); ++i) {
+        CHECK(deserialized[i] == entries[i]);
+        CHECK(deserialized[i].c_str()[deserialized[i].size()] == '\0');
+        if (entries[i].size() > string::inline_capacity)
+            CHECK(deserialized[i].data() == slices[i].data()); // Long strings share its buffer.
+    }
+
+    CHECK(deserialize(serialize(std::vector<slice>{})).empty());
+}
+
+TEST_CASE("serialization outlives blob"
+          * doctest::description("strings returned by tj::deserialize keep the blob alive")
+          * doctest::test_suite("serialization"))
+{
+    std::vector<string> strings;
+    {
+        const std::vector<slice> entries{"first entry too long to be stored inline",
+                                         "second entry too long to be stored inline"};
+        strings = deserialize(serialize(entries));
+    }
+    REQUIRE(strings.size() == 2);
+    CHECK(strings[0] == "first entry too long to be stored inline");
+    CHECK(strings[1] == "second entry too long to be stored inline");
+}
+
+TEST_CASE("serialization validation"
+          * doctest::description("tj::deserialize rejects malformed blobs")
+          * doctest::test_suite("serialization"))
+{
+    const std::vector<slice> entries{"an entry too long to be stored inline"};
+    const auto blob = serialize(entries);
+    const std::string bytes{blob.data(), blob.size()};
+
+    CHECK_THROWS_AS(deserialize_slices(slice{"not a blob"}), std::invalid_argument);
+    CHECK_THROWS_AS(deserialize_slices(slice{bytes.data(), bytes.size() - 8}), std::invalid_argument);
+
+    auto corrupt = bytes;
+    corrupt[8] = 2; // More entries than the offset table has room for.
+    CHECK_THROWS_AS(deserialize_slices(slice{corrupt.data(), corrupt.size()}), std::invalid_argument);
+
+    corrupt = bytes;
+    corrupt[24] = 100; // An entry longer than the blob.
+    CHECK_THROWS_AS(deserialize_slices(slice{corrupt.data(), corrupt.size()}), std::invalid_argument);
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
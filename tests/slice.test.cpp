@@ -7,6 +7,7 @@
 
 #include <cstring>
 #include <doctest.h>
+#include <stdexcept>
 #include <vector>
 
 namespace tj {
@@ -42,6 +43,18 @@ TEST_CASE("tj::string construction"
     CHECK(ss.size() == s.size());
 }
 
+TEST_CASE("mutable tj::string construction"
+          * doctest::description("tj::slice can be constructed from a non-const tj::string")
+          * doctest::test_suite("slice"))
+{
+    string s{"hello, world, how are you?"};
+    const slice ss{s};
+    CHECK(ss.data() == s.data());
+    CHECK(ss.size() == s.size());
+    CHECK(std::distance(ss.begin(), ss.end()) == 26);
+    CHECK(*ss.rbegin() == '?');
+}
+
 TEST_CASE("std::string construction"
           * doctest::description("tj::slice can be constructed from std::string")
           * doctest::test_suite("slice"))
@@ -72,6 +85,18 @@ TEST_CASE("copy construction" * doctest::description("tj::slice can be copy-cons
     CHECK(ss1.size() == ss2.size());
 }
 
+TEST_CASE("substr" * doctest::description("tj::slice::substr refers to the same characters")
+          * doctest::test_suite("slice"))
+{
+    const slice ss{"hello, world"};
+    const auto sub = ss.substr(7, 3);
+    CHECK(sub == "wor");
+    CHECK(sub.data() == ss.data() + 7);
+    CHECK(ss.substr(7) == "world");
+    CHECK(ss.substr(12).empty());
+    CHECK_THROWS_AS(ss.substr(13), std::out_of_range);
+}
+
 TEST_CASE("not constructible from nullptr"
           * doctest::description("tj::slice cannot be constructed from nullptr")
           * doctest::test_suite("slice"))
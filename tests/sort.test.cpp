@@ -0,0 +1,152 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/sort.hpp>
+
+#include <algorithm>
+#include <doctest.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+/// Makes strings that share long prefixes, have duplicates, differ only in
+/// trailing zeros, and are short and long.
+std::vector<std::string> make_keys(std::size_t n)
+{
+    std::mt19937 rng{42};
+    const std::string prefixes[] = {"", "a", "https://example.com/", "https://example.com/index",
+                                    std::string(3, '\0'), "\xff\xfe"};
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i != n; ++i) {
+        auto key = prefixes[rng() % std::size(prefixes)];
+        const auto length = rng() % 4 == 0 ? rng() % 40 : rng() % 6;
+        for (std::size_t j = 0; j != length; ++j)
+            key += static_cast<char>("ab\0\x80z"[rng() % 5]);
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
+
+std::vector<string> to_strings(const std::vector<std::string>& keys)
+{
+    std::vector<string> strings;
+    for (const auto& key : keys)
+        strings.emplace_back(key.data(), key.size());
+    return strings;
+}
+
+bool same(const std::vector<string>& strings, const std::vector<std::string>& keys)
+{
+    return std::equal(strings.begin(), strings.end(), keys.begin(), keys.end(),
+                      [](const string& s, const std::string& key) { return slice{s} == slice{key}; });
+}
+
+} // namespace
+
+TEST_CASE("sort strings" * doctest::description("tj::sort_strings orders strings like operator<")
+          * doctest::test_suite("sort"))
+{
+    for (const std::size_t n : {0, 1, 2, 10, 1000, 20000}) {
+        auto keys = make_keys(n);
+        auto strings = to_strings(keys);
+        sort_strings(strings.begin(), strings.end());
+        std::sort(keys.begin(), keys.end());
+        CHECK(same(strings, keys));
+    }
+
+    std::vector<std::string> std_strings{"pear", "apple", "fig"};
+    sort_strings(std_strings.begin(), std_strings.end());
+    CHECK(std_strings == std::vector<std::string>{"apple", "fig", "pear"});
+}
+
+TEST_CASE("sort in place"
+          * doctest::description("tj::sort_strings moves elements that cannot be default-constructed")
+          * doctest::test_suite("sort"))
+{
+    struct named {
+        explicit named(string s) : name{std::move(s)} {}
+        operator slice() const noexcept { return name; }
+        string name;
+    };
+    const auto keys = make_keys(1000);
+    std::vector<named> names;
+    for (const auto& key : keys)
+        names.emplace_back(string{key.data(), key.size()});
+    sort_strings(names.begin(), names.end());
+    CHECK(std::is_sorted(names.begin(), names.end(),
+                         [](const named& lhs, const named& rhs) { return lhs.name < rhs.name; }));
+}
+
+TEST_CASE("sort equal strings"
+          * doctest::description("tj::sort_strings handles long runs of equal and adversarial keys")
+          * doctest::test_suite("sort"))
+{
+    std::vector<string> equal(5000, string{std::string(100, 'x').c_str()});
+    sort_strings(equal.begin(), equal.end());
+    CHECK(std::all_of(equal.begin(), equal.end(), [](const string& s) { return s.size() == 100; }));
+
+    // Keys that only differ after the prefix are already in order or
+    // reversed, which makes poor pivots.
+    std::vector<std::string> keys;
+    for (int i = 0; i != 3000; ++i)
+        keys.push_back("key " + std::to_string(1000000 - i));
+    auto strings = to_strings(keys);
+    sort_strings(strings.begin(), strings.end());
+    std::sort(keys.begin(), keys.end());
+    CHECK(same(strings, keys));
+}
+
+TEST_CASE("parallel sort strings"
+          * doctest::description("tj::parallel_sort_strings orders strings on several threads")
+          * doctest::test_suite("sort"))
+{
+    auto keys = make_keys(100000);
+    auto strings = to_strings(keys);
+    parallel_sort_strings(strings.begin(), strings.end(), 4);
+    std::sort(keys.begin(), keys.end());
+    CHECK(same(strings, keys));
+
+    std::vector<string> few{string{"b"}, string{"a"}};
+    parallel_sort_strings(few.begin(), few.end());
+    CHECK(few[0] == "a");
+}
+
+TEST_CASE("sort keys" * doctest::description("tj::sort_key orders strings by their cached prefix first")
+          * doctest::test_suite("sort"))
+{
+    auto keys = make_keys(2000);
+    std::sort(keys.begin(), keys.end());
+    std::vector<sort_key> sort_keys;
+    for (const auto& key : keys)
+        sort_keys.emplace_back(string{key.data(), key.size()});
+    for (std::size_t i = 1; i != keys.size(); ++i) {
+        CHECK((sort_keys[i - 1] <=> sort_keys[i]) == (keys[i - 1] <=> keys[i]));
+        CHECK((sort_keys[i] == sort_keys[i - 1]) == (keys[i] == keys[i - 1]));
+    }
+
+    CHECK(sort_key{string{"abcdefgh-suffix"}}.prefix() == 0x6162636465666768);
+    CHECK(sort_key{string{"ab"}}.prefix() == 0x6162000000000000);
+    CHECK(sort_key{}.prefix() == 0);
+    CHECK(sort_key{string{"ab"}} < sort_key{string{"ab\0", 3}});
+
+    std::map<sort_key, int, std::less<>> map;
+    map.emplace(string{"https://example.com/b"}, 2);
+    map.emplace(string{"https://example.com/a"}, 1);
+    map.emplace(string{"zebra"}, 3);
+    CHECK(map.begin()->first.str() == "https://example.com/a");
+    CHECK(map.find(slice{"https://example.com/b"})->second == 2);
+    CHECK(map.find(slice{"zebr"}) == map.end());
+    CHECK(map.contains(string{"zebra"}));
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,110 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/split.hpp>
+
+#include <doctest.h>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+static_assert(std::ranges::forward_range<basic_split_view<slice>>);
+static_assert(std::ranges::view<basic_split_view<slice>>);
+static_assert(std::ranges::common_range<basic_split_view<string>>);
+
+namespace {
+
+template<typename View>
+std::vector<std::string> pieces(const View& view)
+{
+    std::vector<std::string> result;
+    for (const auto piece : view)
+        result.emplace_back(piece.data(), piece.size());
+    return result;
+}
+
+using strings = std::vector<std::string>;
+
+} // namespace
+
+TEST_CASE("split" * doctest::description("tj::split yields the slices between delimiters")
+          * doctest::test_suite("split"))
+{
+    CHECK(pieces(split("a,b,c", ',')) == strings{"a", "b", "c"});
+    CHECK(pieces(split("a,,b,", ',')) == strings{"a", "", "b", ""});
+    CHECK(pieces(split(",", ',')) == strings{"", ""});
+    CHECK(pieces(split("abc", ',')) == strings{"abc"});
+    CHECK(split("", ',').empty());
+
+    CHECK(pieces(split("a::b:c::", "::")) == strings{"a", "b:c", ""});
+    CHECK(pieces(split("a, b;c", delimiter::any_of(", ;"))) == strings{"a", "", "b", "c"});
+    CHECK(pieces(split("a,b", "")) == strings{"a,b"});
+
+    const string s{"GET /index.html HTTP/1.1"};
+    const auto view = split(s, ' ');
+    const auto first = *view.begin();
+    CHECK(first.data() == s.data()); // The slices refer to the split string.
+    CHECK(std::ranges::distance(view) == 3);
+
+    const auto wide = split(wslice{L"x=1&y=2"}, L'&');
+    CHECK(*std::next(wide.begin()) == L"y=2");
+}
+
+TEST_CASE("long split" * doctest::description("tj::split finds delimiters far apart and close together")
+          * doctest::test_suite("split"))
+{
+    std::string text;
+    strings expected;
+    for (int i = 0; i != 200; ++i) {
+        expected.push_back(std::string(static_cast<std::size_t>(i % 40), 'a' + i % 26));
+        text += expected.back();
+        text += i % 3 == 0 ? "\r\n" : i % 3 == 1 ? "," : ";";
+    }
+    expected.emplace_back();
+
+    auto any = pieces(split(text, delimiter::any_of(",;\n")));
+    for (auto& piece : any) {
+        if (!piece.empty() && piece.back() == '\r')
+            piece.pop_back();
+    }
+    CHECK(any == expected);
+
+    std::size_t lines = 0;
+    for (const auto line : split(text, "\r\n")) {
+        CHECK(line.find('\r') == slice::npos);
+        ++lines;
+    }
+    CHECK(lines == 68);
+}
+
+TEST_CASE("split strings"
+          * doctest::description("tj::split_strings yields strings that keep the split string alive")
+          * doctest::test_suite("split"))
+{
+    const std::string tail(100, 't');
+    std::vector<string> parts;
+    {
+        const auto s = string{("key=value;" + std::string(50, 'x') + ";" + tail).c_str()};
+        for (auto piece : split_strings(s, ';'))
+            parts.push_back(std::move(piece));
+        CHECK(parts.back().data() == s.data() + s.size() - tail.size()); // The last piece is shared.
+    }
+    REQUIRE(parts.size() == 3);
+    CHECK(parts[0] == "key=value");
+    CHECK(parts[1] == std::string(50, 'x'));
+    CHECK(parts[2] == tail);
+    CHECK(parts[2].c_str()[tail.size()] == '\0');
+
+    auto sizes = split_strings(string{"a bc"}, ' ')
+                 | std::views::transform([](const string& piece) { return piece.size(); });
+    CHECK(*std::next(sizes.begin()) == 2);
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,101 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+static_assert(details::stats_enabled, "the tests are built with TJ_STRING_STATS");
+
+TEST_CASE("stats counting" * doctest::description("tj::stats counts allocations, copies and constructions")
+          * doctest::test_suite("stats"))
+{
+    const char* text = "a string too long to be stored inline";
+    const auto before = stats();
+    {
+        const string s1{text};
+        const string s2{s1};
+        const string s3{"GET", 3};
+        auto after = stats();
+        CHECK(after.allocations - before.allocations == 1);
+        CHECK(after.live_buffers() - before.live_buffers() == 1);
+        CHECK(after.live_bytes() - before.live_bytes() > s1.size());
+        CHECK(after.copies - before.copies == 1);
+        CHECK(after.external_constructions - before.external_constructions == 1);
+        CHECK(after.inline_constructions - before.inline_constructions == 1);
+        CHECK(after.length_histogram[6] - before.length_histogram[6] == 1); // 37 is in [32, 64)
+        CHECK(after.length_histogram[2] - before.length_histogram[2] == 1); // 3 is in [2, 4)
+    }
+    const auto after = stats();
+    CHECK(after.frees - before.frees == 1);
+    CHECK(after.releases - before.releases == 2);
+    CHECK(after.live_bytes() == before.live_bytes());
+}
+
+TEST_CASE("stats literals" * doctest::description("tj::string refers to literals without allocating")
+          * doctest::test_suite("stats"))
+{
+    const auto before = stats();
+    const auto s1 = string::from_literal("a literal too long to be stored inline");
+    const auto s2 = string::from_literal("another literal too long to be stored inline");
+    const auto after = stats();
+    CHECK(after.allocations == before.allocations);
+    CHECK(after.external_constructions == before.external_constructions);
+    CHECK(s1 != s2);
+}
+
+TEST_CASE("stats threads" * doctest::description("tj::stats includes the counters of exited threads")
+          * doctest::test_suite("stats"))
+{
+    const char* text = "a string too long to be stored inline";
+    const auto before = stats();
+    string s;
+    std::thread{[&] { s = string{text}; }}.join();
+    const auto after = stats();
+    CHECK(after.allocations - before.allocations == 1);
+    CHECK(after.external_constructions - before.external_constructions == 1);
+}
+
+TEST_CASE("stats make strings" * doctest::description("tj::make_strings allocates a single buffer")
+          * doctest::test_suite("stats"))
+{
+    const std::vector<std::string> row{"id", "a field too long to be stored inline", "",
+                                       "another field too long to be stored inline"};
+    const auto before = stats();
+    const auto strings = make_strings(row);
+    const auto after = stats();
+    CHECK(after.allocations - before.allocations == 1);
+    // The buffer they share is built as one string, and the long fields are
+    // substrings of it.
+    CHECK(after.external_constructions - before.external_constructions == 1);
+    CHECK(after.shared_constructions - before.shared_constructions == 2);
+    CHECK(after.inline_constructions - before.inline_constructions == 2);
+}
+
+TEST_CASE("stats builder" * doctest::description("tj::stats counts strings built by tj::string_builder")
+          * doctest::test_suite("stats"))
+{
+    const auto before = stats();
+    string_builder builder;
+    builder.append("a string built by appending ");
+    builder.append("too many characters to be inline");
+    const auto s = std::move(builder).str();
+    const auto literal = string::from_literal("a literal that is shared from");
+    const auto literal_part = literal.share_substr(2);
+    const auto after = stats();
+    CHECK(after.external_constructions - before.external_constructions == 1);
+    CHECK(after.length_histogram[6] - before.length_histogram[6] == 1); // 60 is in [32, 64)
+    CHECK(after.literal_constructions - before.literal_constructions == 1);
+    CHECK(literal_part == "literal that is shared from");
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
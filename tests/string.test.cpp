@@ -5,7 +5,14 @@
 
 #include "compile_time_tests.hpp"
 
+#include <algorithm>
 #include <doctest.h>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 
 namespace tj {
@@ -30,6 +37,61 @@ TEST_CASE("literal construction"
     CHECK(s.size() == strlen("hello, world"));
 }
 
+TEST_CASE("string constant construction"
+          * doctest::description("tj::string::from_literal refers to string constants instead of copying them")
+          * doctest::test_suite("string"))
+{
+    static constexpr char constant[] = "a string too long to be stored inline";
+    const auto s1 = string::from_literal(constant);
+    CHECK(s1.data() == constant);
+    const auto s2 = string::from_literal("a literal too long to be stored inline");
+    CHECK(s2 == "a literal too long to be stored inline");
+
+    string s3;
+    s3 = string::from_literal(constant);
+    CHECK(s3.data() == constant);
+}
+
+TEST_CASE("array construction"
+          * doctest::description("tj::string copies arrays that are not constants")
+          * doctest::test_suite("string"))
+{
+    const char local[] = "a local array too long to be stored inline";
+    const string s1{local};
+    CHECK(s1.data() != local);
+    CHECK(s1 == local);
+
+    char mutable_array[] = "a string too long to be stored inline";
+    const string s2{mutable_array};
+    CHECK(s2.data() != mutable_array);
+    CHECK(s2 == "a string too long to be stored inline");
+
+    std::vector<string> v;
+    v.emplace_back("a literal forwarded by emplace_back");
+    CHECK(v.back() == "a literal forwarded by emplace_back");
+}
+
+TEST_CASE("array assignment"
+          * doctest::description("tj::string copies arrays when they are assigned")
+          * doctest::test_suite("string"))
+{
+    struct request {
+        char method[4];
+        const char name[36];
+    };
+    const request r{"GET", "a name too long to be stored inline"};
+
+    string s;
+    s = r.name;
+    CHECK(s == "a name too long to be stored inline");
+    CHECK(s.data() != r.name);
+    s = r.method;
+    CHECK(s == "GET");
+
+    s = "a literal too long to be stored inline";
+    CHECK(s == "a literal too long to be stored inline");
+}
+
 TEST_CASE("user-defined literal construction"
           * doctest::description("tj::string can be constructed from a user-defined literal")
           * doctest::test_suite("string"))
@@ -39,6 +101,27 @@ TEST_CASE("user-defined literal construction"
     CHECK(s.size() == strlen("hello, world"));
 }
 
+TEST_CASE("character type user-defined literal construction"
+          * doctest::description("_is makes a tj::basic_string of the literal's character type")
+          * doctest::test_suite("string"))
+{
+    using namespace tj::literals;
+    static_assert(std::is_same_v<decltype(L"hello"_is), wstring>);
+    static_assert(std::is_same_v<decltype(u8"hello"_is), basic_string<char8_t>>);
+    static_assert(std::is_same_v<decltype(u"hello"_is), basic_string<char16_t>>);
+    static_assert(std::is_same_v<decltype(U"hello"_is), basic_string<char32_t>>);
+    static_assert(u"a string too long to be stored inline"_is.size() == 37);
+    static_assert(U"hello"_is.hash() == basic_slice<char32_t>{U"hello"}.hash());
+
+    // Literals are referenced rather than copied, even when too long to inline.
+    const auto s1 = u"a string too long to be stored inline"_is;
+    const auto s2 = u"a string too long to be stored inline"_is;
+    CHECK(s1.c_str() == s2.c_str());
+    CHECK(s1 == std::u16string_view{u"a string too long to be stored inline"});
+    CHECK(L"wide"_is == L"wide");
+    CHECK(u8"\u00e6\u00f8\u00e5"_is.size() == 6);
+}
+
 TEST_CASE("character pointer construction"
           * doctest::description("tj::string can be constructed from a character pointer")
           * doctest::test_suite("string"))
@@ -52,7 +135,7 @@ TEST_CASE("character pointer construction"
 TEST_CASE("copy construction" * doctest::description("tj::string can be copy-constructed")
           * doctest::test_suite("string"))
 {
-    const string l1{"hello, world"};
+    const string l1{"hello, world, how are you?"};
     const string l2{l1};           // You can create a copy of a literal,
     CHECK(l2.data() == l1.data()); // but it must be shallow
 
@@ -62,6 +145,236 @@ TEST_CASE("copy construction" * doctest::description("tj::string can be copy-con
     CHECK(h1.data() != l1.data()); // h1 must be heap-allocated
 }
 
+TEST_CASE("inline construction"
+          * doctest::description("short tj::strings are stored inside the string object")
+          * doctest::test_suite("string"))
+{
+    static_assert(string::inline_capacity >= 14);
+
+    const char* s = "GET";
+    const string s1{s};
+    const auto begin = reinterpret_cast<const char*>(&s1);
+    CHECK(s1.data() >= begin); // Short strings must not allocate memory,
+    CHECK(s1.data() < begin + sizeof(s1));
+    CHECK(s1 == "GET"); // but the contents must be the same,
+    CHECK(s1.size() == 3);
+    CHECK(s1.c_str()[3] == '\0'); // and null-terminated.
+
+    const string s2{s1};
+    CHECK(s2.data() != s1.data()); // Copies carry their own characters
+    CHECK(s2 == s1);
+
+    const std::string longest(string::inline_capacity, 'x');
+    const string s3{longest.data(), longest.size()};
+    CHECK(s3.size() == longest.size());
+    CHECK(s3.c_str()[longest.size()] == '\0');
+    CHECK(std::equal(s3.data(), s3.data() + s3.size(), longest.data()));
+}
+
+TEST_CASE("wide inline construction"
+          * doctest::description("short tj::wstrings are stored inside the string object")
+          * doctest::test_suite("string"))
+{
+    const wchar_t* s = L"ab";
+    const wstring s1{s};
+    CHECK(s1.size() == 2);
+    CHECK(s1.c_str()[0] == L'a');
+    CHECK(s1.c_str()[1] == L'b');
+    CHECK(s1.c_str()[2] == L'\0');
+}
+
+TEST_CASE("move construction" * doctest::description("tj::string can be move-constructed")
+          * doctest::test_suite("string"))
+{
+    static_assert(std::is_nothrow_move_constructible_v<string>);
+
+    string h1{"hello, world, how are you?", 26};
+    const auto data = h1.data();
+    const string h2{std::move(h1)};
+    CHECK(h2.data() == data); // The buffer must be stolen, not copied,
+    CHECK(h2 == "hello, world, how are you?");
+    CHECK(h1.size() == 0); // and the moved-from string must be left empty
+    CHECK(*h1.c_str() == '\0');
+}
+
+TEST_CASE("move assignment" * doctest::description("tj::string can be move-assigned")
+          * doctest::test_suite("string"))
+{
+    static_assert(std::is_nothrow_move_assignable_v<string>);
+
+    string h1{"hello, world, how are you?", 26};
+    const auto data = h1.data();
+    string h2{"goodbye", 7};
+    h2 = std::move(h1);
+    CHECK(h2.data() == data);
+    CHECK(h2 == "hello, world, how are you?");
+    CHECK(h1.size() == 0);
+    CHECK(*h1.c_str() == '\0');
+}
+
+TEST_CASE("swap" * doctest::description("tj::string can be swapped")
+          * doctest::test_suite("string"))
+{
+    using namespace tj::literals;
+    string h1{"hello, world", 12};
+    string l1 = "goodbye"_is;
+    h1.swap(l1);
+    CHECK(h1 == "goodbye");
+    CHECK(l1 == "hello, world");
+}
+
+TEST_CASE("local string copy construction"
+          * doctest::description("tj::local_string shares buffers without atomic ref-counting")
+          * doctest::test_suite("string"))
+{
+    const char* text = "hello, world, how are you?";
+    const local_string h1{text};
+    {
+        const local_string h2{h1};
+        CHECK(h2.data() == h1.data());
+        local_string h3{"goodbye"};
+        h3 = h2;
+        CHECK(h3.data() == h1.data());
+    }
+    CHECK(h1 == "hello, world, how are you?"); // h1 must outlive its copies
+
+    const slice s{h1};
+    CHECK(s.data() == h1.data());
+    CHECK(s.size() == h1.size());
+}
+
+TEST_CASE("allocator construction"
+          * doctest::description("tj::pmr::string allocates through its memory resource")
+          * doctest::test_suite("string"))
+{
+    struct counting_resource : std::pmr::memory_resource {
+        std::size_t allocated = 0;
+        std::size_t deallocated = 0;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocated += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            deallocated += bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    } resource;
+
+    {
+        const pmr::string s1{"hello, world, how are you?", &resource};
+        CHECK(s1 == "hello, world, how are you?");
+        CHECK(resource.allocated > s1.size()); // External buffers come from the resource,
+
+        const pmr::string s2{s1};
+        CHECK(s2.data() == s1.data());
+
+        const auto allocated = resource.allocated;
+        const pmr::string s3{"GET", &resource};
+        CHECK(resource.allocated == allocated); // but inline strings do not allocate.
+        CHECK(resource.deallocated == 0);
+    }
+    CHECK(resource.deallocated == resource.allocated); // The last copy frees through it.
+}
+
+TEST_CASE("share substring"
+          * doctest::description("tj::string::share_substr shares the buffer of suffixes")
+          * doctest::test_suite("string"))
+{
+    char s[] = "a string too long to be stored inline";
+    string suffix;
+    const char* data;
+    {
+        const string parent{s};
+        data = parent.c_str();
+        suffix = parent.share_substr(2);
+        CHECK(suffix.c_str() == data + 2);
+    }
+    CHECK(suffix == "string too long to be stored inline");
+    CHECK(suffix.c_str() == data + 2);
+    CHECK(suffix.c_str()[suffix.size()] == '\0');
+
+    const string copy{suffix};
+    CHECK(copy.c_str() == suffix.c_str());
+    CHECK(copy.hash() == hash{}(slice{"string too long to be stored inline"}));
+
+    const auto nested = suffix.share_substr(7, 100);
+    CHECK(nested == "too long to be stored inline");
+    CHECK(nested.c_str() == data + 9);
+}
+
+TEST_CASE("copy substring"
+          * doctest::description("tj::string::share_substr copies interior substrings")
+          * doctest::test_suite("string"))
+{
+    using namespace tj::literals;
+    char s[] = "a string too long to be stored inline";
+    const string parent{s};
+
+    const auto interior = parent.share_substr(2, 30);
+    CHECK(interior == "string too long to be stored i");
+    CHECK(interior.c_str() != parent.c_str() + 2);
+    CHECK(interior.c_str()[interior.size()] == '\0');
+
+    const auto short_piece = parent.share_substr(2, 6);
+    CHECK(short_piece == "string");
+    CHECK(short_piece.c_str()[6] == '\0');
+
+    const auto literal = "a string too long to be stored inline"_is;
+    CHECK(literal.share_substr(2).c_str() == literal.c_str() + 2);
+
+    CHECK(parent.share_substr(parent.size()).empty());
+    CHECK_THROWS_AS(parent.share_substr(parent.size() + 1), std::out_of_range);
+}
+
+TEST_CASE("shared slice"
+          * doctest::description("tj::string::share_slice shares the buffer of any substring")
+          * doctest::test_suite("string"))
+{
+    using namespace tj::literals;
+    char s[] = "a string too long to be stored inline";
+    shared_slice interior;
+    const char* data;
+    {
+        const string parent{s};
+        data = parent.data();
+        interior = parent.share_slice(2, 30);
+    }
+    // The slice keeps the buffer alive after the string is gone.
+    CHECK(interior == "string too long to be stored i");
+    CHECK(interior.data() == data + 2);
+    CHECK(interior.hash() == slice{"string too long to be stored i"}.hash());
+
+    const auto nested = interior.share_substr(7, 8);
+    CHECK(nested == "too long");
+    CHECK(nested.data() == data + 9);
+    CHECK_THROWS_AS(interior.share_substr(31), std::out_of_range);
+
+    // Slices of inline strings follow the characters when they are moved.
+    auto short_piece = string{s, 8}.share_slice(2);
+    const auto moved = std::move(short_piece);
+    CHECK(moved == "string");
+
+    const auto literal = "a string too long to be stored inline"_is;
+    CHECK(literal.share_slice(2, 6).data() == literal.data() + 2);
+    CHECK(literal.share_slice(2, 6).str() == "string");
+    CHECK(literal.share_slice(2).str().c_str() == literal.c_str() + 2);
+
+    const string parent{s};
+    CHECK(parent.share_slice().str().data() == parent.data());
+    CHECK(parent.share_slice(parent.size()).empty());
+    CHECK(shared_slice{}.empty());
+    CHECK_THROWS_AS(parent.share_slice(parent.size() + 1), std::out_of_range);
+}
+
 TEST_CASE("not constructible from nullptr"
           * doctest::description("tj::string cannot be constructed from nullptr")
           * doctest::test_suite("string"))
@@ -0,0 +1,150 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/string.hpp>
+
+#include <doctest.h>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+TEST_CASE("append" * doctest::description("tj::string_builder appends slices and characters")
+          * doctest::test_suite("string_builder"))
+{
+    string_builder b;
+    CHECK(b.empty());
+    b.append("hello").append(1, ',') += ' ';
+    b += std::string{"world"};
+    b.push_back('!');
+    CHECK(b.size() == 13);
+    CHECK(b.view() == "hello, world!");
+
+    const auto s = std::move(b).str();
+    CHECK(s == "hello, world!");
+    CHECK(b.empty());
+}
+
+TEST_CASE("hand-off" * doctest::description("tj::string_builder hands its buffer to the string")
+          * doctest::test_suite("string_builder"))
+{
+    string_builder b{64};
+    CHECK(b.capacity() == 64);
+    b.append("a string too long to be stored inline");
+    const auto data = b.view().data();
+    const auto s = std::move(b).str();
+    CHECK(s == "a string too long to be stored inline");
+    CHECK(s.c_str() == data);
+    CHECK(s.c_str()[s.size()] == '\0');
+    CHECK(b.capacity() == 0);
+
+    const string copy{s};
+    CHECK(copy.data() == s.data());
+    CHECK(s.share_substr(2) == "string too long to be stored inline");
+}
+
+TEST_CASE("growth" * doctest::description("tj::string_builder grows past its capacity")
+          * doctest::test_suite("string_builder"))
+{
+    string_builder b{4};
+    std::string expected;
+    for (int i = 0; i != 100; ++i) {
+        b.append("0123456789");
+        expected += "0123456789";
+    }
+    CHECK(b.capacity() >= 1000);
+    CHECK(std::move(b).str() == slice{expected});
+}
+
+TEST_CASE("self-append" * doctest::description("tj::string_builder appends its own characters while growing")
+          * doctest::test_suite("string_builder"))
+{
+    string_builder b;
+    b.append("0123456789");
+    std::string expected = "0123456789";
+    for (int i = 0; i != 6; ++i) {
+        b.append(b.view());
+        b.append(b.view().substr(1, 3));
+        expected += expected;
+        expected += expected.substr(1, 3);
+    }
+    b.append_with(b.capacity(), [old = b.view()](char* p, std::size_t) {
+        std::copy_n(old.data(), old.size(), p);
+        return old.size();
+    });
+    expected += expected;
+    CHECK(std::move(b).str() == slice{expected});
+}
+
+TEST_CASE("single allocation"
+          * doctest::description("tj::string_builder allocates once when reserved")
+          * doctest::test_suite("string_builder"))
+{
+    struct counting_resource : std::pmr::memory_resource {
+        int allocations = 0;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    } resource;
+
+    using builder = basic_string_builder<char, std::char_traits<char>, std::pmr::polymorphic_allocator<char>>;
+    builder b{32, &resource};
+    b.append("key:").append("a fairly long value").append(";");
+    const auto s = std::move(b).str();
+    CHECK(s == "key:a fairly long value;");
+    CHECK(resource.allocations == 1);
+}
+
+TEST_CASE("concat" * doctest::description("tj::concat joins slice-convertible arguments")
+          * doctest::test_suite("string_builder"))
+{
+    using namespace std::literals;
+    char mutable_part[] = "mutable ";
+    const string s{"a string too long to be stored inline"};
+
+    CHECK(concat() == "");
+    CHECK(concat("GET", " ", "/"s) == "GET /");
+    CHECK(concat(mutable_part, s, ", "sv, slice{"end"}) == "mutable a string too long to be stored inline, end");
+    CHECK(concat(L"wide", L" string"s) == L"wide string");
+}
+
+TEST_CASE("make strings"
+          * doctest::description("tj::make_strings copies all parts into one shared buffer")
+          * doctest::test_suite("string_builder"))
+{
+    const std::vector<std::string> row{"id", "a field too long to be stored inline", "",
+                                       "another field too long to be stored inline"};
+
+    const auto strings = make_strings(row);
+
+    REQUIRE(strings.size() == row.size());
+    for (std::size_t i = 0; i != row.size(); ++i) {
+        CHECK(strings[i] == row[i]);
+        CHECK(strings[i].c_str()[strings[i].size()] == '\0');
+    }
+    CHECK(strings[3].data() == strings[1].data() + strings[1].size() + 1); // Adjacent in memory.
+
+    CHECK(make_strings(std::vector<slice>{"GET", "/"}).size() == 2);
+    CHECK(make_strings(std::vector<std::wstring>{L"wide"})[0] == L"wide");
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj
@@ -0,0 +1,163 @@
+// Copyright Teis Johansen 2021
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://boost.org/LICENSE_1_0.txt)
+#include <tj/utf.hpp>
+
+#include <doctest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tj {
+inline namespace v1 {
+namespace test {
+
+namespace {
+
+// "Hello, wörld! €100 😀" in each encoding: ASCII, and 2-, 3- and 4-byte UTF-8.
+constexpr std::string_view utf8 = "Hello, w\xc3\xb6rld! \xe2\x82\xac" "100 \xf0\x9f\x98\x80";
+constexpr std::u16string_view utf16 = u"Hello, wörld! €100 \U0001f600";
+constexpr std::u32string_view utf32 = U"Hello, wörld! €100 \U0001f600";
+
+constexpr std::string_view invalid_utf8[] = {"\xc0\x80",         // overlong
+                                             "\xe0\x80\xaf",     // overlong
+                                             "\xed\xa0\x80",     // surrogate
+                                             "\xf4\x90\x80\x80", // beyond U+10FFFF
+                                             "\xf8\x88\x80\x80", // no such lead byte
+                                             "\x80",             // stray continuation
+                                             "abc\xe2\x82",      // truncated
+                                             "\xe2\x28\xa1"};    // bad continuation
+
+std::vector<details::utf::utf8_kernels> supported_kernels()
+{
+    std::vector<details::utf::utf8_kernels> kernels{details::utf::scalar_kernels};
+#if defined(TJ_STRING_UTF8_DISPATCH)
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+        kernels.push_back(details::utf::sse4_kernels);
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+        kernels.push_back(details::utf::avx2_kernels);
+#endif
+    return kernels;
+}
+
+} // namespace
+
+TEST_CASE("transcoding" * doctest::description("tj::to_utf8, to_utf16 and to_utf32 convert between encodings")
+          * doctest::test_suite("utf"))
+{
+    CHECK(to_utf16(slice{utf8.data(), utf8.size()}) == utf16);
+    CHECK(to_utf32(slice{utf8.data(), utf8.size()}) == utf32);
+    CHECK(to_utf16(u32slice{utf32.data(), utf32.size()}) == utf16);
+    CHECK(to_utf32(u16slice{utf16.data(), utf16.size()}) == utf32);
+    CHECK(to_utf8(u16slice{utf16.data(), utf16.size()}) == utf8);
+    CHECK(to_utf8(u32slice{utf32.data(), utf32.size()}) == utf8);
+
+    CHECK(to_utf16(slice{""}).empty());
+    CHECK(to_utf8(u"GET") == "GET");
+}
+
+TEST_CASE("long transcoding"
+          * doctest::description("transcoding copies runs of ASCII and handles what follows them")
+          * doctest::test_suite("utf"))
+{
+    std::string s8;
+    std::u16string s16;
+    std::u32string s32;
+    for (int i = 0; i != 50; ++i) {
+        const std::string ascii(static_cast<std::size_t>(i), 'a' + i % 26);
+        s8 += ascii;
+        s16.append(ascii.begin(), ascii.end());
+        s32.append(ascii.begin(), ascii.end());
+        s8 += utf8;
+        s16 += utf16;
+        s32 += utf32;
+    }
+
+    const auto u16 = to_utf16(slice{s8.data(), s8.size()});
+    CHECK(u16 == std::u16string_view{s16});
+    CHECK(u16.c_str()[u16.size()] == u'\0');
+    CHECK(to_utf32(slice{s8.data(), s8.size()}) == std::u32string_view{s32});
+    CHECK(to_utf8(u16slice{s16.data(), s16.size()}) == std::string_view{s8});
+    CHECK(to_utf8(u32slice{s32.data(), s32.size()}) == std::string_view{s8});
+    CHECK(to_utf16(u32slice{s32.data(), s32.size()}) == std::u16string_view{s16});
+}
+
+TEST_CASE("invalid transcoding"
+          * doctest::description("transcoding rejects input that is not valid in its encoding")
+          * doctest::test_suite("utf"))
+{
+    for (const auto invalid : invalid_utf8) {
+        CHECK_THROWS_AS(to_utf16(slice{invalid.data(), invalid.size()}), std::invalid_argument);
+        CHECK_THROWS_AS(to_utf32(slice{invalid.data(), invalid.size()}), std::invalid_argument);
+    }
+
+    const char16_t lone_high[] = {u'a', 0xd83d, u'b'};
+    const char16_t lone_low[] = {0xde00};
+    CHECK_THROWS_AS(to_utf8(u16slice{lone_high, 3}), std::invalid_argument);
+    CHECK_THROWS_AS(to_utf8(u16slice{lone_low, 1}), std::invalid_argument);
+
+    const char32_t beyond[] = {0x110000};
+    const char32_t surrogate[] = {0xd800};
+    CHECK_THROWS_AS(to_utf8(u32slice{beyond, 1}), std::invalid_argument);
+    CHECK_THROWS_AS(to_utf16(u32slice{surrogate, 1}), std::invalid_argument);
+}
+
+TEST_CASE("utf-8 validation"
+          * doctest::description("tj::is_valid_utf8 agrees with the decoder wherever the error is")
+          * doctest::test_suite("utf"))
+{
+    CHECK(is_valid_utf8(""));
+    CHECK(is_valid_utf8(slice{utf8.data(), utf8.size()}));
+    CHECK_FALSE(is_valid_utf8("\xff"));
+
+    for (const auto& kernels : supported_kernels()) {
+        // Place each sequence at every offset of two vectors, so that it is
+        // split between vectors, and at the end of the input.
+        for (std::size_t offset = 0; offset != 70; ++offset) {
+            const std::string ascii(offset, 'a');
+            const auto valid = ascii + std::string{utf8} + ascii;
+            CHECK(kernels.validate(valid.data(), valid.size(), nullptr));
+            CHECK(kernels.validate(valid.data(), offset + utf8.size(), nullptr));
+            CHECK(kernels.count(valid.data(), valid.size()) == 2 * offset + utf32.size());
+
+            for (const auto invalid : invalid_utf8) {
+                const auto padded = ascii + std::string{invalid} + ascii;
+                CHECK_FALSE(kernels.validate(padded.data(), padded.size(), nullptr));
+                CHECK_FALSE(kernels.validate(padded.data(), offset + invalid.size(), nullptr));
+            }
+            for (std::size_t cut = 1; cut != 4; ++cut) {
+                const auto truncated = ascii + "\xf0\x9f\x98\x80";
+                CHECK_FALSE(kernels.validate(truncated.data(), truncated.size() - cut, nullptr));
+            }
+        }
+
+        std::string copy(utf8.size(), '\0');
+        CHECK(kernels.validate(utf8.data(), utf8.size(), copy.data()));
+        CHECK(copy == utf8);
+    }
+}
+
+TEST_CASE("validated utf-8 strings"
+          * doctest::description("tj::validated_utf8_string copies valid UTF-8 and rejects the rest")
+          * doctest::test_suite("utf"))
+{
+    CHECK(validated_utf8_string("GET") == "GET");
+    CHECK(count_code_points(slice{utf8.data(), utf8.size()}) == utf32.size());
+
+    std::string text;
+    while (text.size() < 1000)
+        text += utf8;
+    const auto s = validated_utf8_string(slice{text.data(), text.size()});
+    CHECK(s == std::string_view{text});
+    CHECK(s.c_str()[s.size()] == '\0');
+    CHECK(count_code_points(s) == text.size() / utf8.size() * utf32.size());
+
+    CHECK_THROWS_AS(validated_utf8_string("\xc0\x80"), std::invalid_argument);
+    text += "\xed\xa0\x80";
+    CHECK_THROWS_AS(validated_utf8_string(slice{text.data(), text.size()}), std::invalid_argument);
+}
+
+} // namespace test
+} // namespace v1
+} // namespace tj